@@ -0,0 +1,95 @@
+#define DT_DRV_COMPAT sck_fake_pwm
+
+#include "fake_pwm.h"
+#include <errno.h>
+#include <zephyr/drivers/pwm.h>
+
+struct fake_pwm_data {
+    uint32_t period[FAKE_PWM_CHANNELS];
+    uint32_t pulse[FAKE_PWM_CHANNELS];
+    uint32_t set_count;
+    uint32_t last_cycle;
+    struct k_sem update_sem;
+};
+
+static int fake_pwm_set_cycles(const struct device *dev, uint32_t channel,
+                               uint32_t period_cycles, uint32_t pulse_cycles,
+                               pwm_flags_t flags)
+{
+    struct fake_pwm_data *data = dev->data;
+
+    ARG_UNUSED(flags);
+
+    if (channel >= FAKE_PWM_CHANNELS) {
+        return -EINVAL;
+    }
+    data->period[channel] = period_cycles;
+    data->pulse[channel] = pulse_cycles;
+    data->set_count++;
+    data->last_cycle = k_cycle_get_32();
+    k_sem_give(&data->update_sem);
+    return 0;
+}
+
+// 1周期 = 1ns，pwm_set_dt 传入的ns值原样落到 set_cycles
+static int fake_pwm_get_cycles_per_sec(const struct device *dev, uint32_t channel,
+                                       uint64_t *cycles)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(channel);
+
+    *cycles = NSEC_PER_SEC;
+    return 0;
+}
+
+static const struct pwm_driver_api fake_pwm_api = {
+    .set_cycles = fake_pwm_set_cycles,
+    .get_cycles_per_sec = fake_pwm_get_cycles_per_sec,
+};
+
+int fake_pwm_wait(const struct device *dev, k_timeout_t timeout, uint32_t *cycle)
+{
+    struct fake_pwm_data *data = dev->data;
+
+    if (k_sem_take(&data->update_sem, timeout) != 0) {
+        return -EAGAIN;
+    }
+    *cycle = data->last_cycle;
+    return 0;
+}
+
+void fake_pwm_reset(const struct device *dev)
+{
+    struct fake_pwm_data *data = dev->data;
+
+    k_sem_reset(&data->update_sem);
+}
+
+uint32_t fake_pwm_pulse(const struct device *dev, uint32_t channel)
+{
+    const struct fake_pwm_data *data = dev->data;
+
+    return channel < FAKE_PWM_CHANNELS ? data->pulse[channel] : 0;
+}
+
+uint32_t fake_pwm_set_count(const struct device *dev)
+{
+    const struct fake_pwm_data *data = dev->data;
+
+    return data->set_count;
+}
+
+static int fake_pwm_init(const struct device *dev)
+{
+    struct fake_pwm_data *data = dev->data;
+
+    k_sem_init(&data->update_sem, 0, 1);
+    return 0;
+}
+
+#define FAKE_PWM_DEFINE(n)                                                  \
+    static struct fake_pwm_data fake_pwm_data_##n;                          \
+    DEVICE_DT_INST_DEFINE(n, fake_pwm_init, NULL, &fake_pwm_data_##n, NULL, \
+                          POST_KERNEL, CONFIG_PWM_INIT_PRIORITY, &fake_pwm_api);
+
+DT_INST_FOREACH_STATUS_OKAY(FAKE_PWM_DEFINE)
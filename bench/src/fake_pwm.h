@@ -0,0 +1,17 @@
+#ifndef FAKE_PWM_H
+#define FAKE_PWM_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+#define FAKE_PWM_CHANNELS 4
+
+// 等待下一次 set_cycles，返回0并给出更新时刻的周期计数，超时返回-EAGAIN
+int fake_pwm_wait(const struct device *dev, k_timeout_t timeout, uint32_t *cycle);
+// 丢弃之前的更新通知
+void fake_pwm_reset(const struct device *dev);
+uint32_t fake_pwm_pulse(const struct device *dev, uint32_t channel);
+uint32_t fake_pwm_set_count(const struct device *dev);
+
+#endif
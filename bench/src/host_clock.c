@@ -0,0 +1,13 @@
+// runner上下文（宿主机libc）：native_sim的内核时间是仿真时间，纯计算不会推进，
+// 测CPU耗时必须用宿主机时钟。
+
+#include <stdint.h>
+#include <time.h>
+
+uint64_t bench_host_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,396 @@
+// SmartControlKit 性能基准（native_sim）
+//
+// 每项结果输出一行，字段顺序固定，便于脚本采集做回归对比：
+//   bench,<名称>,<单位>,<次数>,<min>,<mean>,<max>
+// 单位 ns 为宿主机CPU耗时；sim_us 为仿真时间下的延迟（反映消抖、调度等固有等待）。
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/kernel.h>
+
+#include "accel_block.h"
+#include "button_input.h"
+#include "fake_pwm.h"
+#include "led_control.h"
+#include "motor_driver.h"
+#include "orient_filter.h"
+#include "output_sched.h"
+#include "pwm_out.h"
+#include "tap_detector.h"
+#include "trace_codec.h"
+
+#define DETECT_SAMPLES      20000
+#define BLOCK_SAMPLES       32      // 一次FIFO排空的样本数（200Hz、160ms）
+#define ORIENT_SAMPLES      20000
+#define SET_COLOR_ITERS     2000
+#define MODE_SWITCH_ITERS   50
+#define BUTTON_ITERS        20
+#define OVERLAY_ITERS       10
+#define OVERLAY_MS          100
+#define WAIT_TIMEOUT        K_MSEC(1000)
+
+typedef struct {
+    uint32_t n;
+    uint64_t min, max, sum;
+} bench_stats_t;
+
+#ifdef CONFIG_ARCH_POSIX
+extern uint64_t bench_host_now_ns(void);
+#elif defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+static uint64_t bench_host_now_ns(void)
+{
+    return k_cyc_to_ns_floor64(k_cycle_get_64());
+}
+#else
+// 板上运行时退回32位周期计数，回绕的那一次测量会失真
+static uint64_t bench_host_now_ns(void)
+{
+    return k_cyc_to_ns_floor64(k_cycle_get_32());
+}
+#endif
+
+static const struct device *const pwm_led = DEVICE_DT_GET(DT_NODELABEL(fake_pwm_led));
+static const struct device *const pwm_motor = DEVICE_DT_GET(DT_NODELABEL(fake_pwm_motor));
+static const struct gpio_dt_spec sw0 = GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios);
+
+static void stats_add(bench_stats_t *st, uint64_t v)
+{
+    if (st->n == 0 || v < st->min) st->min = v;
+    if (v > st->max) st->max = v;
+    st->sum += v;
+    st->n++;
+}
+
+static void stats_print(const char *name, const char *unit, const bench_stats_t *st)
+{
+    printk("bench,%s,%s,%u,%llu,%llu,%llu\n", name, unit, st->n,
+           (unsigned long long)st->min,
+           (unsigned long long)(st->n ? st->sum / st->n : 0),
+           (unsigned long long)st->max);
+}
+
+static uint64_t cyc_delta_us(uint32_t from, uint32_t to)
+{
+    return k_cyc_to_us_floor64((uint32_t)(to - from));
+}
+
+// ===== 检测器每样本耗时 =====
+// 合成数据：静止1g加小噪声，每2s一组间隔200ms的两次冲击，覆盖校准和敲击判定分支
+static void make_sample(AccelSample *s, int i)
+{
+    static uint32_t lfsr = 0xACE1u;
+    int phase = i % 100;
+
+    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+    s->ax = (int16_t)((lfsr & 0x7F) - 64);
+    s->ay = (int16_t)(((lfsr >> 7) & 0x7F) - 64);
+    s->az = 16384;
+    if (phase == 50 || phase == 60) {
+        s->az = 16384 + 20000 / 2;
+        s->ax += 12000;
+    }
+    s->ts = (int64_t)i * SAMPLING_INTERVAL_MS;
+}
+
+static void bench_detector(void)
+{
+    static TapDetector det;
+    static TapDetectorQ det_q;
+    static AccelSample samples[DETECT_SAMPLES];
+    bench_stats_t st_f = {0}, st_q = {0};
+
+    for (int i = 0; i < DETECT_SAMPLES; i++) {
+        make_sample(&samples[i], i);
+    }
+
+    tap_detector_init(&det, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+
+    for (int i = 0; i < DETECT_SAMPLES; i++) {
+        uint64_t t0 = bench_host_now_ns();
+        tap_detector_process(&det, &samples[i]);
+        uint64_t t1 = bench_host_now_ns();
+        tap_detector_q_process(&det_q, &samples[i]);
+        uint64_t t2 = bench_host_now_ns();
+
+        stats_add(&st_f, t1 - t0);
+        stats_add(&st_q, t2 - t1);
+    }
+    stats_print("detect_sample_float", "ns", &st_f);
+    stats_print("detect_sample_fixed", "ns", &st_q);
+}
+
+// ===== 批量模长内核和批量检测，每批耗时 =====
+// 与 bench_detector 相同的合成数据，按FIFO排空的批大小切分。mag_block_ref 为逐样本
+// C实现（平方和 + 逐位开方），mag_block_simd/mag_block_c 为当前平台实际使用的批量内核
+static void bench_block(void)
+{
+    static AccelSample samples[DETECT_SAMPLES];
+    static TapDetectorQ det_q, det_b;
+    static int32_t ref[BLOCK_SAMPLES], mag[BLOCK_SAMPLES], smooth[BLOCK_SAMPLES];
+    bench_stats_t st_ref = {0}, st_mag = {0}, st_q = {0}, st_b = {0};
+    int32_t seed = 0;
+    int mismatch = 0;
+
+    for (int i = 0; i < DETECT_SAMPLES; i++) {
+        make_sample(&samples[i], i);
+    }
+
+    tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    tap_detector_q_init(&det_b, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+
+    for (int i = 0; i + BLOCK_SAMPLES <= DETECT_SAMPLES; i += BLOCK_SAMPLES) {
+        const AccelSample *blk = &samples[i];
+
+        uint64_t t0 = bench_host_now_ns();
+        accel_block_mag_ref(&blk->ax, sizeof(*blk), BLOCK_SAMPLES, ref);
+        uint64_t t1 = bench_host_now_ns();
+        accel_block_mag(&blk->ax, sizeof(*blk), BLOCK_SAMPLES, seed, mag);
+        uint64_t t2 = bench_host_now_ns();
+        for (int k = 0; k < BLOCK_SAMPLES; k++) {
+            tap_detector_q_process(&det_q, &blk[k]);
+        }
+        uint64_t t3 = bench_host_now_ns();
+        tap_detector_q_prepare(&det_b, blk, sizeof(*blk), BLOCK_SAMPLES, mag, smooth);
+        for (int k = 0; k < BLOCK_SAMPLES; k++) {
+            tap_detector_q_process_prepared(&det_b, &blk[k], mag[k], smooth[k]);
+        }
+        uint64_t t4 = bench_host_now_ns();
+
+        stats_add(&st_ref, t1 - t0);
+        stats_add(&st_mag, t2 - t1);
+        stats_add(&st_q, t3 - t2);
+        stats_add(&st_b, t4 - t3);
+        for (int k = 0; k < BLOCK_SAMPLES; k++) {
+            mismatch += ref[k] != mag[k];
+        }
+        seed = mag[BLOCK_SAMPLES - 1];
+    }
+    stats_print("mag_block_ref", "ns", &st_ref);
+    stats_print(ACCEL_BLOCK_SIMD ? "mag_block_simd" : "mag_block_c", "ns", &st_mag);
+    stats_print("detect_block_fixed_sample", "ns", &st_q);
+    stats_print("detect_block_fixed", "ns", &st_b);
+    if (mismatch) {
+        printk("bench,mag_block: %d magnitudes differ from reference\n", mismatch);
+    }
+}
+
+// ===== 现场记录器的块压缩，每样本耗时 =====
+// 与 bench_detector 相同的合成数据，块满时开新块（记录器在检测线程里逐样本调用）。
+// trace_encode_size 为块内每个样本的编码字节数（不含块头）
+static void bench_trace_encode(void)
+{
+    static AccelSample samples[DETECT_SAMPLES];
+    static uint8_t blk[TRACE_BLOCK_SIZE];
+    TraceBlockEnc enc;
+    bench_stats_t st = {0}, size = {0};
+    uint32_t seq = 0;
+
+    for (int i = 0; i < DETECT_SAMPLES; i++) {
+        make_sample(&samples[i], i);
+    }
+
+    trace_block_start(&enc, blk, seq, &samples[0]);
+    for (int i = 1; i < DETECT_SAMPLES; i++) {
+        uint16_t before = enc.len;
+        uint64_t t0 = bench_host_now_ns();
+        bool fit = trace_block_append(&enc, &samples[i]);
+        if (!fit) {
+            trace_block_start(&enc, blk, ++seq, &samples[i]);
+        }
+        stats_add(&st, bench_host_now_ns() - t0);
+        if (fit) {
+            stats_add(&size, enc.len - before);
+        }
+    }
+    stats_print("trace_encode", "ns", &st);
+    stats_print("trace_encode_size", "bytes", &size);
+}
+
+// ===== 姿态滤波 + 旋转抑制输入，每样本耗时 =====
+// 合成数据：绕x轴以50°/s来回转腕（0~50°三角波，周期2s），加速度取对应的重力方向
+// （小角度近似，模长偏离1g不超过门控，校正分支每个样本都会执行）
+static void bench_orient_filter(void)
+{
+    static ImuSample samples[ORIENT_SAMPLES];
+    static OrientFilter f;
+    static TapDetectorQ det_q;
+    bench_stats_t st = {0};
+    int16_t grav[3];
+
+    for (int i = 0; i < ORIENT_SAMPLES; i++) {
+        ImuSample *s = &samples[i];
+        int phase = i % 100;
+        int32_t deg = phase < 50 ? phase : 100 - phase;
+
+        s->acc.ax = 0;
+        s->acc.ay = (int16_t)(deg * 16384 / 57);
+        s->acc.az = (int16_t)(16384 - deg * deg * 16384 / (2 * 3283));   // 3283 = (180/pi)^2
+        s->acc.ts = (int64_t)i * SAMPLING_INTERVAL_MS;
+        s->gx = (int16_t)((phase < 50 ? 50 : -50) * SCK_MPU6050_GYRO_COUNTS_PER_DPS_X10 / 10);
+        s->gy = 0;
+        s->gz = 0;
+    }
+
+    orient_filter_init(&f);
+    tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+
+    for (int i = 0; i < ORIENT_SAMPLES; i++) {
+        uint64_t t0 = bench_host_now_ns();
+        orient_filter_update(&f, &samples[i]);
+        orient_filter_gravity(&f, grav);
+        tap_detector_q_set_attitude(&det_q, grav, f.rate_dps);
+        stats_add(&st, bench_host_now_ns() - t0);
+    }
+    stats_print("orient_update", "ns", &st);
+}
+
+// ===== led_control_set_color 单次耗时（红蓝两路暂存后批量提交）=====
+static void bench_led_set_color(void)
+{
+    bench_stats_t st = {0};
+
+    for (int i = 0; i < SET_COLOR_ITERS; i++) {
+        uint64_t t0 = bench_host_now_ns();
+        led_control_set_color(i % 101, 100 - i % 101);
+        stats_add(&st, bench_host_now_ns() - t0);
+    }
+    stats_print("led_set_color", "ns", &st);
+}
+
+// ===== 模式切换到第一次PWM更新的延迟 =====
+static void bench_led_mode_switch(void)
+{
+    bench_stats_t host = {0}, sim = {0};
+
+    for (int i = 0; i < MODE_SWITCH_ITERS; i++) {
+        // 在两个静态模式之间切换，避免动态效果的帧更新混入
+        led_mode_t mode = (i & 1) ? LED_MODE_RED : LED_MODE_BLUE;
+        uint32_t cyc;
+
+        fake_pwm_reset(pwm_led);
+        uint32_t c0 = k_cycle_get_32();
+        uint64_t t0 = bench_host_now_ns();
+        led_control_set_mode(mode);
+        if (fake_pwm_wait(pwm_led, WAIT_TIMEOUT, &cyc) != 0) {
+            printk("bench,led_mode_switch,timeout\n");
+            return;
+        }
+        stats_add(&host, bench_host_now_ns() - t0);
+        stats_add(&sim, cyc_delta_us(c0, cyc));
+    }
+    stats_print("led_mode_switch", "ns", &host);
+    stats_print("led_mode_switch", "sim_us", &sim);
+}
+
+// ===== 提示层叠加再恢复：每次叠加的合成帧数和实际PWM写入次数 =====
+static void bench_led_overlay(void)
+{
+    bench_stats_t frames = {0}, writes = {0};
+
+    led_control_set_mode(LED_MODE_RED);
+    k_msleep(10);
+    for (int i = 0; i < OVERLAY_ITERS; i++) {
+        uint32_t f0, w0, f1, w1;
+
+        led_control_get_stats(&f0, &w0);
+        led_control_push_layer(LED_LAYER_NOTIFY, LED_MODE_BLUE, 255, OVERLAY_MS);
+        k_msleep(OVERLAY_MS + 20);
+        led_control_get_stats(&f1, &w1);
+
+        // 到期后应恢复基础层的红色
+        if (fake_pwm_pulse(pwm_led, 1) != 0) {
+            printk("bench,led_overlay,not_restored\n");
+            return;
+        }
+        stats_add(&frames, f1 - f0);
+        stats_add(&writes, w1 - w0);
+    }
+    stats_print("led_overlay", "frames", &frames);
+    stats_print("led_overlay", "pwm_writes", &writes);
+}
+
+static void bench_motor_mode_switch(void)
+{
+    bench_stats_t host = {0}, sim = {0};
+
+    for (int i = 0; i < MODE_SWITCH_ITERS; i++) {
+        motor_vib_mode_t mode = (i & 1) ? MOTOR_VIB_TAP : MOTOR_VIB_LONG;
+        uint32_t cyc;
+
+        fake_pwm_reset(pwm_motor);
+        uint32_t c0 = k_cycle_get_32();
+        uint64_t t0 = bench_host_now_ns();
+        motor_driver_set_mode(mode);
+        if (fake_pwm_wait(pwm_motor, WAIT_TIMEOUT, &cyc) != 0) {
+            printk("bench,motor_mode_switch,timeout\n");
+            return;
+        }
+        stats_add(&host, bench_host_now_ns() - t0);
+        stats_add(&sim, cyc_delta_us(c0, cyc));
+        k_msleep(5);
+    }
+    motor_driver_set_mode(MOTOR_VIB_OFF);
+    stats_print("motor_mode_switch", "ns", &host);
+    stats_print("motor_mode_switch", "sim_us", &sim);
+}
+
+// ===== 按钮边沿到回调的延迟（含消抖等待）=====
+static K_SEM_DEFINE(btn_sem, 0, 1);
+static volatile uint32_t btn_cb_cycle;
+
+static void bench_button_cb(const button_event_t *evt)
+{
+    if (evt->index == BUTTON_SW0 && evt->type == BUTTON_EVT_PRESS) {
+        btn_cb_cycle = k_cycle_get_32();
+        k_sem_give(&btn_sem);
+    }
+}
+
+static void bench_button_latency(void)
+{
+    bench_stats_t sim = {0};
+
+    for (int i = 0; i < BUTTON_ITERS; i++) {
+        // 高电平为按下（ACTIVE_LOW配置下 gpio_pin_get_dt 为0）；带两次抖动
+        uint32_t c0 = k_cycle_get_32();
+        gpio_emul_input_set(sw0.port, sw0.pin, 1);
+        k_usleep(300);
+        gpio_emul_input_set(sw0.port, sw0.pin, 0);
+        k_usleep(300);
+        gpio_emul_input_set(sw0.port, sw0.pin, 1);
+
+        if (k_sem_take(&btn_sem, WAIT_TIMEOUT) != 0) {
+            printk("bench,button_press,timeout\n");
+            return;
+        }
+        stats_add(&sim, cyc_delta_us(c0, btn_cb_cycle));
+
+        gpio_emul_input_set(sw0.port, sw0.pin, 0);
+        // 等松开确认和多击间隔结束，下一次按下从干净状态开始
+        k_msleep(BUTTON_DEBOUNCE_MS + BUTTON_MULTI_CLICK_MS + 50);
+    }
+    stats_print("button_press", "sim_us", &sim);
+}
+
+int main(void)
+{
+    output_sched_init();
+    pwm_out_init();
+    led_control_init();
+    motor_driver_init();
+    button_input_init(bench_button_cb);
+
+    printk("# bench,name,unit,n,min,mean,max\n");
+    bench_detector();
+    bench_block();
+    bench_trace_encode();
+    bench_orient_filter();
+    bench_led_set_color();
+    bench_led_mode_switch();
+    bench_led_overlay();
+    bench_motor_mode_switch();
+    bench_button_latency();
+    printk("bench,done\n");
+    return 0;
+}
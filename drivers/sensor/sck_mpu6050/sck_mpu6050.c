@@ -0,0 +1,580 @@
+#define DT_DRV_COMPAT sck_mpu6050
+
+#include "sck_mpu6050.h"
+#include <drivers/sck_mpu6050.h>
+#include <zephyr/logging/log.h>
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#endif
+#include <zephyr/sys/byteorder.h>
+
+LOG_MODULE_REGISTER(sck_mpu6050, CONFIG_SENSOR_LOG_LEVEL);
+
+#if defined(CONFIG_SCK_MPU6050_TRIGGER) || defined(CONFIG_SENSOR_ASYNC_API)
+// 中断回调和异步读取都在这个队列里做I2C，调用线程不被总线传输阻塞
+K_THREAD_STACK_DEFINE(sck_mpu6050_workq_stack, CONFIG_SCK_MPU6050_WORKQ_STACK_SIZE);
+static struct k_work_q sck_mpu6050_wq;
+static bool workq_started;
+
+struct k_work_q *sck_mpu6050_workq(void)
+{
+    return &sck_mpu6050_wq;
+}
+
+static void workq_start_once(void)
+{
+    const struct k_work_queue_config cfg = {
+        .name = "sck_mpu6050",
+    };
+
+    if (workq_started) {
+        return;
+    }
+    k_work_queue_init(&sck_mpu6050_wq);
+    k_work_queue_start(&sck_mpu6050_wq, sck_mpu6050_workq_stack,
+                       K_THREAD_STACK_SIZEOF(sck_mpu6050_workq_stack),
+                       CONFIG_SCK_MPU6050_WORKQ_PRIORITY, &cfg);
+    workq_started = true;
+}
+#endif
+
+// ===== 总线运行时电源管理 =====
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+static bool bus_suspended(const struct device *bus)
+{
+    enum pm_device_state state;
+
+    return pm_device_state_get(bus, &state) == 0 && state == PM_DEVICE_STATE_SUSPENDED;
+}
+
+int sck_mpu6050_bus_get(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+
+    if (bus_suspended(cfg->i2c.bus)) {
+        atomic_inc(&data->bus_resumes);
+    }
+    return pm_device_runtime_get(cfg->i2c.bus);
+}
+
+void sck_mpu6050_bus_put(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+
+    if (pm_device_runtime_put(cfg->i2c.bus) == 0 && bus_suspended(cfg->i2c.bus)) {
+        atomic_inc(&data->bus_suspends);
+    }
+}
+#endif
+
+int sck_mpu6050_bus_pm_stats(const struct device *dev, uint32_t *resumes, uint32_t *suspends)
+{
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+
+    if (!pm_device_runtime_is_enabled(cfg->i2c.bus)) {
+        return -ENOTSUP;
+    }
+    *resumes = (uint32_t)atomic_get(&data->bus_resumes);
+    *suspends = (uint32_t)atomic_get(&data->bus_suspends);
+    return 0;
+#else
+    ARG_UNUSED(dev);
+    ARG_UNUSED(resumes);
+    ARG_UNUSED(suspends);
+    return -ENOTSUP;
+#endif
+}
+
+static int fifo_reset(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+
+    data->next_ts_ns = k_ticks_to_ns_floor64(k_uptime_ticks());
+    return i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_USER_CTRL,
+                                 MPU6050_USER_FIFO_EN | MPU6050_USER_FIFO_RESET);
+}
+
+static int write_regs(const struct device *dev, const uint8_t (*regs)[2], size_t n)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+
+    for (size_t i = 0; i < n; i++) {
+        int ret = i2c_reg_write_byte_dt(&cfg->i2c, regs[i][0], regs[i][1]);
+        if (ret != 0) {
+            LOG_ERR("write 0x%02x failed: %d", regs[i][0], ret);
+            return ret;
+        }
+    }
+    return 0;
+}
+
+// 低通带宽不超过采样率的一半附近：200Hz以上放宽到94Hz，其余保持44Hz
+static uint8_t dlpf_cfg(uint8_t smplrt_div)
+{
+    return smplrt_div < 5 ? MPU6050_DLPF_CFG_94HZ : MPU6050_DLPF_CFG_44HZ;
+}
+
+static int configure(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    const uint8_t regs[][2] = {
+        {MPU6050_REG_CONFIG,       dlpf_cfg(data->smplrt_div)},
+        {MPU6050_REG_SMPLRT_DIV,   data->smplrt_div},        // 1kHz / (1 + div)
+        {MPU6050_REG_GYRO_CONFIG,  MPU6050_GYRO_FS_1000},
+        {MPU6050_REG_ACCEL_CONFIG, 0x00},                    // ±2g
+        {MPU6050_REG_INT_PIN_CFG,  0x00},                    // 高电平有效，推挽，50us脉冲
+        {MPU6050_REG_FIFO_EN,      cfg->fifo_watermark ? MPU6050_FIFO_EN_ALL : 0},
+    };
+    uint8_t id;
+    int ret;
+
+    ret = i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_PWR_MGMT_1, MPU6050_PWR_RESET);
+    if (ret != 0) {
+        LOG_ERR("reset failed: %d", ret);
+        return ret;
+    }
+    k_msleep(100);
+
+    ret = i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_PWR_MGMT_1, MPU6050_PWR_CLK_PLL_X);
+    if (ret != 0) {
+        LOG_ERR("wakeup failed: %d", ret);
+        return ret;
+    }
+    k_msleep(10);
+
+    ret = i2c_reg_read_byte_dt(&cfg->i2c, MPU6050_REG_WHO_AM_I, &id);
+    if (ret != 0 || id != MPU6050_WHO_AM_I_VAL) {
+        LOG_ERR("unexpected WHO_AM_I 0x%02x (%d)", id, ret);
+        return ret != 0 ? ret : -ENODEV;
+    }
+
+    ret = write_regs(dev, regs, ARRAY_SIZE(regs));
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (cfg->fifo_watermark) {
+        ret = fifo_reset(dev);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    data->low_power = false;
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    atomic_set(&data->drdy_count, 0);
+#endif
+    return i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_INT_ENABLE, sck_mpu6050_int_mask(dev));
+}
+
+uint8_t sck_mpu6050_int_mask(const struct device *dev)
+{
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    const struct sck_mpu6050_data *data = dev->data;
+
+    if (data->low_power) {
+        return data->motion_handler ? MPU6050_INT_MOT : 0;
+    }
+    return data->drdy_handler ? (MPU6050_INT_DATA_RDY | MPU6050_INT_FIFO_OFLOW) : 0;
+#else
+    ARG_UNUSED(dev);
+    return 0;
+#endif
+}
+
+int sck_mpu6050_configure(const struct device *dev)
+{
+    int ret = sck_mpu6050_bus_get(dev);
+
+    if (ret == 0) {
+        ret = configure(dev);
+        sck_mpu6050_bus_put(dev);
+    }
+    return ret;
+}
+
+// 低功耗周期模式：陀螺仪待机、关温度和FIFO，加速度计按 hz 周期唤醒做运动检测
+static int enter_low_power(const struct device *dev, int hz)
+{
+    struct sck_mpu6050_data *data = dev->data;
+    uint8_t lp_wake = hz <= 1 ? 0 : hz <= 5 ? 1 : hz <= 20 ? 2 : 3;
+    const uint8_t regs[][2] = {
+        {MPU6050_REG_INT_ENABLE,   0},                       // 切换过程中不出中断
+        {MPU6050_REG_USER_CTRL,    0},
+        {MPU6050_REG_FIFO_EN,      0},
+        {MPU6050_REG_ACCEL_CONFIG, MPU6050_ACCEL_HPF_5HZ},   // 运动检测比较高通后的加速度
+        {MPU6050_REG_MOT_THR,      data->mot_thr},
+        {MPU6050_REG_MOT_DUR,      data->mot_dur},
+        {MPU6050_REG_PWR_MGMT_2,   (lp_wake << MPU6050_PWR2_LP_WAKE_SHIFT) | MPU6050_PWR2_STBY_GYRO},
+        {MPU6050_REG_PWR_MGMT_1,   MPU6050_PWR_CYCLE | MPU6050_PWR_TEMP_DIS},
+    };
+    const struct sck_mpu6050_config *cfg = dev->config;
+    int ret = write_regs(dev, regs, ARRAY_SIZE(regs));
+
+    if (ret != 0) {
+        return ret;
+    }
+    data->low_power = true;
+    return i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_INT_ENABLE, sck_mpu6050_int_mask(dev));
+}
+
+// 回到全速采样：不复位芯片，只恢复时钟、量程和FIFO，尽快接上后续样本。
+// 陀螺仪从待机启动约需30ms，最前面几帧的角速度不可信
+static int exit_low_power(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    const uint8_t regs[][2] = {
+        {MPU6050_REG_INT_ENABLE,   0},
+        {MPU6050_REG_PWR_MGMT_1,   MPU6050_PWR_CLK_PLL_X},
+        {MPU6050_REG_PWR_MGMT_2,   0},
+        {MPU6050_REG_ACCEL_CONFIG, 0x00},
+        {MPU6050_REG_FIFO_EN,      cfg->fifo_watermark ? MPU6050_FIFO_EN_ALL : 0},
+    };
+    int ret = write_regs(dev, regs, ARRAY_SIZE(regs));
+
+    if (ret != 0) {
+        return ret;
+    }
+    data->low_power = false;
+    if (cfg->fifo_watermark) {
+        ret = fifo_reset(dev);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    atomic_set(&data->drdy_count, 0);
+#endif
+    return i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_INT_ENABLE, sck_mpu6050_int_mask(dev));
+}
+
+// 运行中改采样率。FIFO里旧采样率的样本无法再按序号推算时间戳，随之清空，
+// 序号按新周期重新对齐到当前时间。调用者保证没有异步读取在途
+static int set_sample_rate(const struct device *dev, int hz)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+
+    if (hz < 4 || hz > 1000) {
+        return -EINVAL;                 // 分频寄存器8位，1kHz下最低约4Hz
+    }
+    if (data->low_power) {
+        return -EBUSY;
+    }
+
+    uint8_t div = (uint8_t)(1000 / hz - 1);
+    const uint8_t regs[][2] = {
+        {MPU6050_REG_CONFIG,       dlpf_cfg(div)},
+        {MPU6050_REG_SMPLRT_DIV,   div},
+    };
+    int ret = write_regs(dev, regs, ARRAY_SIZE(regs));
+
+    if (ret != 0) {
+        return ret;
+    }
+    data->smplrt_div = div;
+    data->period_ns = (div + 1) * NSEC_PER_MSEC;
+    return cfg->fifo_watermark ? fifo_reset(dev) : 0;
+}
+
+// 帧内全是大端int16，原地转成本机字节序
+static void frames_from_be(struct sck_mpu6050_frame *frames, int n)
+{
+    uint8_t *raw = (uint8_t *)frames;
+
+    for (int i = 0; i < n * MPU6050_SAMPLE_BYTES / 2; i++) {
+        ((int16_t *)frames)[i] = (int16_t)sys_get_be16(&raw[2 * i]);
+    }
+}
+
+int sck_mpu6050_read_frame(const struct device *dev, struct sck_mpu6050_frame *out)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    int ret = sck_mpu6050_bus_get(dev);
+
+    if (ret != 0) {
+        return ret;
+    }
+    ret = i2c_burst_read_dt(&cfg->i2c, MPU6050_REG_ACCEL_XOUT_H, (uint8_t *)out,
+                            MPU6050_SAMPLE_BYTES);
+    sck_mpu6050_bus_put(dev);
+    if (ret != 0) {
+        return ret;
+    }
+    frames_from_be(out, 1);
+    return 0;
+}
+
+static int fifo_read(const struct device *dev, struct sck_mpu6050_frame *out, int max,
+                     bool *overflow)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    uint8_t cnt_buf[2];
+    uint8_t status;
+    int ret;
+
+    *overflow = false;
+
+    ret = i2c_reg_read_byte_dt(&cfg->i2c, MPU6050_REG_INT_STATUS, &status);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = i2c_burst_read_dt(&cfg->i2c, MPU6050_REG_FIFO_COUNT_H, cnt_buf, sizeof(cnt_buf));
+    if (ret != 0) {
+        return ret;
+    }
+
+    int count = sys_get_be16(cnt_buf);
+    if ((status & MPU6050_INT_FIFO_OFLOW) || count >= MPU6050_FIFO_SIZE) {
+        // 溢出后FIFO内样本边界已不可信，丢弃并按当前时间重新对齐序号
+        LOG_WRN("FIFO overflow, reset");
+        *overflow = true;
+        ret = fifo_reset(dev);
+        return ret != 0 ? ret : 0;
+    }
+
+    int n = MIN(count / MPU6050_SAMPLE_BYTES, max);
+    if (n == 0) {
+        return 0;
+    }
+
+    // 直接读进输出缓冲，再原地把大端转成本机字节序
+    ret = i2c_burst_read_dt(&cfg->i2c, MPU6050_REG_FIFO_R_W, (uint8_t *)out,
+                            n * MPU6050_SAMPLE_BYTES);
+    if (ret != 0) {
+        return ret;
+    }
+    frames_from_be(out, n);
+    return n;
+}
+
+int sck_mpu6050_fifo_read(const struct device *dev, struct sck_mpu6050_frame *out, int max,
+                          bool *overflow)
+{
+    int ret = sck_mpu6050_bus_get(dev);
+
+    if (ret != 0) {
+        *overflow = false;
+        return ret;
+    }
+    ret = fifo_read(dev, out, max, overflow);
+    sck_mpu6050_bus_put(dev);
+    return ret;
+}
+
+int sck_mpu6050_recover(const struct device *dev)
+{
+    return sck_mpu6050_configure(dev);
+}
+
+static int sck_mpu6050_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+    struct sck_mpu6050_data *data = dev->data;
+
+    switch ((int)chan) {
+    case SENSOR_CHAN_ALL:
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+    case SENSOR_CHAN_ACCEL_XYZ:
+    case SENSOR_CHAN_GYRO_X:
+    case SENSOR_CHAN_GYRO_Y:
+    case SENSOR_CHAN_GYRO_Z:
+    case SENSOR_CHAN_GYRO_XYZ:
+    case SENSOR_CHAN_DIE_TEMP:
+    case SENSOR_CHAN_SCK_MPU6050_RAW_XYZ:
+    case SENSOR_CHAN_SCK_MPU6050_RAW_GYRO_XYZ:
+        // 不管要哪个通道都整帧读，一次I2C传输
+        return sck_mpu6050_read_frame(dev, &data->sample);
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static void counts_to_ms2(int16_t counts, struct sensor_value *val)
+{
+    int64_t ug = (int64_t)counts * 1000000 / MPU6050_COUNTS_PER_G;
+
+    sensor_ug_to_ms2((int32_t)ug, val);
+}
+
+static void gyro_counts_to_rad(int16_t counts, struct sensor_value *val)
+{
+    // 单位 10 udeg/s：counts / 32.8 * 1e5
+    int32_t d = (int32_t)((int64_t)counts * 1000000 / SCK_MPU6050_GYRO_COUNTS_PER_DPS_X10);
+
+    sensor_10udegrees_to_rad(d, val);
+}
+
+static int sck_mpu6050_channel_get(const struct device *dev, enum sensor_channel chan,
+                                   struct sensor_value *val)
+{
+    struct sck_mpu6050_data *data = dev->data;
+
+    const struct sck_mpu6050_frame *f = &data->sample;
+
+    switch ((int)chan) {
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+        counts_to_ms2(f->accel[chan - SENSOR_CHAN_ACCEL_X], val);
+        return 0;
+    case SENSOR_CHAN_ACCEL_XYZ:
+        for (int i = 0; i < 3; i++) {
+            counts_to_ms2(f->accel[i], &val[i]);
+        }
+        return 0;
+    case SENSOR_CHAN_GYRO_X:
+    case SENSOR_CHAN_GYRO_Y:
+    case SENSOR_CHAN_GYRO_Z:
+        gyro_counts_to_rad(f->gyro[chan - SENSOR_CHAN_GYRO_X], val);
+        return 0;
+    case SENSOR_CHAN_GYRO_XYZ:
+        for (int i = 0; i < 3; i++) {
+            gyro_counts_to_rad(f->gyro[i], &val[i]);
+        }
+        return 0;
+    case SENSOR_CHAN_DIE_TEMP: {
+        int32_t mc = (int32_t)f->temp * 1000 / MPU6050_TEMP_COUNTS_PER_C + MPU6050_TEMP_OFFSET_MC;
+        val->val1 = mc / 1000;
+        val->val2 = (mc % 1000) * 1000;
+        return 0;
+    }
+    case SENSOR_CHAN_SCK_MPU6050_RAW_XYZ:
+    case SENSOR_CHAN_SCK_MPU6050_RAW_GYRO_XYZ: {
+        const int16_t *raw = chan == (enum sensor_channel)SENSOR_CHAN_SCK_MPU6050_RAW_XYZ ?
+                             f->accel : f->gyro;
+        for (int i = 0; i < 3; i++) {
+            val[i].val1 = raw[i];
+            val[i].val2 = 0;
+        }
+        return 0;
+    }
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int attr_set(const struct device *dev, enum sensor_channel chan,
+                    enum sensor_attribute attr, const struct sensor_value *val)
+{
+    struct sck_mpu6050_data *data = dev->data;
+
+    ARG_UNUSED(chan);
+
+    switch ((int)attr) {
+    case SENSOR_ATTR_SLOPE_TH: {
+        int32_t mg = sensor_ms2_to_ug(val) / 1000;
+        data->mot_thr = CLAMP(mg / MPU6050_MOT_THR_MG_PER_LSB, 1, UINT8_MAX);
+        return 0;
+    }
+    case SENSOR_ATTR_SLOPE_DUR:
+        data->mot_dur = CLAMP(val->val1, 1, UINT8_MAX);     // 1ms/LSB
+        return 0;
+    case SENSOR_ATTR_SAMPLING_FREQUENCY:
+        return set_sample_rate(dev, val->val1);
+    case SENSOR_ATTR_SCK_MPU6050_LOW_POWER:
+        if (val->val1 < 0) {
+            return -EINVAL;
+        }
+        if (val->val1 == 0) {
+            return data->low_power ? exit_low_power(dev) : 0;
+        }
+        return enter_low_power(dev, val->val1);
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int sck_mpu6050_attr_set(const struct device *dev, enum sensor_channel chan,
+                                enum sensor_attribute attr, const struct sensor_value *val)
+{
+    int ret = sck_mpu6050_bus_get(dev);
+
+    if (ret == 0) {
+        ret = attr_set(dev, chan, attr, val);
+        sck_mpu6050_bus_put(dev);
+    }
+    return ret;
+}
+
+static const struct sensor_driver_api sck_mpu6050_api = {
+    .attr_set = sck_mpu6050_attr_set,
+    .sample_fetch = sck_mpu6050_sample_fetch,
+    .channel_get = sck_mpu6050_channel_get,
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    .trigger_set = sck_mpu6050_trigger_set,
+#endif
+#ifdef CONFIG_SENSOR_ASYNC_API
+    .submit = sck_mpu6050_submit,
+    .get_decoder = sck_mpu6050_get_decoder,
+#endif
+};
+
+static int sck_mpu6050_init(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    int ret;
+
+    if (!i2c_is_ready_dt(&cfg->i2c)) {
+        LOG_ERR("I2C bus not ready");
+        return -ENODEV;
+    }
+
+    // 开DLPF后内部采样率1kHz
+    data->smplrt_div = cfg->smplrt_div;
+    data->period_ns = (cfg->smplrt_div + 1) * NSEC_PER_MSEC;
+    data->mot_thr = 50 / MPU6050_MOT_THR_MG_PER_LSB;      // 默认50mg
+    data->mot_dur = 1;
+
+#if defined(CONFIG_SCK_MPU6050_TRIGGER) || defined(CONFIG_SENSOR_ASYNC_API)
+    workq_start_once();
+#endif
+
+    ret = sck_mpu6050_configure(dev);
+    if (ret != 0) {
+        return ret;
+    }
+
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    if (cfg->int_gpio.port) {
+        ret = sck_mpu6050_trigger_init(dev);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+#endif
+#ifdef CONFIG_SENSOR_ASYNC_API
+    sck_mpu6050_async_init(dev);
+#endif
+
+    LOG_INF("%s: %u Hz, FIFO watermark %u", dev->name,
+            (unsigned)(NSEC_PER_SEC / data->period_ns), cfg->fifo_watermark);
+    return 0;
+}
+
+#define SCK_MPU6050_DEFINE(inst)                                                        \
+    BUILD_ASSERT(DT_INST_PROP(inst, fifo_watermark) * 2 * MPU6050_SAMPLE_BYTES <=      \
+                 MPU6050_FIFO_SIZE, "fifo-watermark too large for MPU6050 FIFO");      \
+    static struct sck_mpu6050_data sck_mpu6050_data_##inst;                             \
+    static const struct sck_mpu6050_config sck_mpu6050_config_##inst = {               \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                                              \
+        .int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0}),                     \
+        .smplrt_div = DT_INST_PROP(inst, smplrt_div),                                   \
+        .fifo_watermark = DT_INST_PROP(inst, fifo_watermark),                           \
+    };                                                                                  \
+    SENSOR_DEVICE_DT_INST_DEFINE(inst, sck_mpu6050_init, NULL,                          \
+                                 &sck_mpu6050_data_##inst, &sck_mpu6050_config_##inst,  \
+                                 POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,              \
+                                 &sck_mpu6050_api);
+
+DT_INST_FOREACH_STATUS_OKAY(SCK_MPU6050_DEFINE)
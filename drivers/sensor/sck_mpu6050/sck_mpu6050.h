@@ -0,0 +1,157 @@
+#ifndef SCK_MPU6050_INTERNAL_H
+#define SCK_MPU6050_INTERNAL_H
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <drivers/sck_mpu6050.h>
+
+// ===== MPU6050 寄存器 =====
+#define MPU6050_REG_SMPLRT_DIV   0x19
+#define MPU6050_REG_CONFIG       0x1A
+#define MPU6050_REG_GYRO_CONFIG  0x1B
+#define MPU6050_REG_ACCEL_CONFIG 0x1C
+#define MPU6050_REG_MOT_THR      0x1F
+#define MPU6050_REG_MOT_DUR      0x20
+#define MPU6050_REG_FIFO_EN      0x23
+#define MPU6050_REG_INT_PIN_CFG  0x37
+#define MPU6050_REG_INT_ENABLE   0x38
+#define MPU6050_REG_INT_STATUS   0x3A
+#define MPU6050_REG_ACCEL_XOUT_H 0x3B
+#define MPU6050_REG_USER_CTRL    0x6A
+#define MPU6050_REG_PWR_MGMT_1   0x6B
+#define MPU6050_REG_PWR_MGMT_2   0x6C
+#define MPU6050_REG_FIFO_COUNT_H 0x72
+#define MPU6050_REG_FIFO_R_W     0x74
+#define MPU6050_REG_WHO_AM_I     0x75
+
+#define MPU6050_PWR_RESET        0x80
+#define MPU6050_PWR_CLK_PLL_X    0x01
+#define MPU6050_PWR_CYCLE        0x20
+#define MPU6050_PWR_TEMP_DIS     0x08
+#define MPU6050_PWR2_STBY_GYRO   0x07
+#define MPU6050_PWR2_LP_WAKE_SHIFT 6
+#define MPU6050_ACCEL_HPF_5HZ    0x01
+#define MPU6050_MOT_THR_MG_PER_LSB 2
+#define MPU6050_FIFO_EN_ACCEL    0x08
+#define MPU6050_FIFO_EN_ALL      0xF8    // 温度 + 陀螺仪XYZ + 加速度，每帧14字节，顺序同 0x3B~0x48
+#define MPU6050_GYRO_FS_1000     0x10    // ±1000°/s，手腕翻转不饱和
+#define MPU6050_INT_DATA_RDY     0x01
+#define MPU6050_INT_FIFO_OFLOW   0x10
+#define MPU6050_INT_MOT          0x40
+#define MPU6050_USER_FIFO_EN     0x40
+#define MPU6050_USER_FIFO_RESET  0x04
+#define MPU6050_DLPF_CFG_44HZ    0x03    // 开DLPF后内部采样率为1kHz
+#define MPU6050_DLPF_CFG_94HZ    0x02    // 采样率200Hz以上时用，不压低冲击的上升沿
+#define MPU6050_WHO_AM_I_VAL     0x68
+
+#define MPU6050_FIFO_SIZE        1024
+#define MPU6050_SAMPLE_BYTES     14
+#define MPU6050_COUNTS_PER_G     16384   // ±2g量程
+#define MPU6050_TEMP_COUNTS_PER_C 340    // °C = counts / 340 + 36.53
+#define MPU6050_TEMP_OFFSET_MC   36530
+
+struct sck_mpu6050_config {
+    struct i2c_dt_spec i2c;
+    struct gpio_dt_spec int_gpio;       // 未配置时 port 为 NULL
+    uint8_t smplrt_div;                 // 上电默认采样率，运行中可用 SAMPLING_FREQUENCY 属性修改
+    uint8_t fifo_watermark;             // 0 表示不用FIFO
+};
+
+// 一帧原始数据（已转本机字节序），布局与芯片寄存器/FIFO帧一致
+struct sck_mpu6050_frame {
+    int16_t accel[3];
+    int16_t temp;
+    int16_t gyro[3];
+};
+
+BUILD_ASSERT(sizeof(struct sck_mpu6050_frame) == MPU6050_SAMPLE_BYTES, "frame layout");
+
+struct sck_mpu6050_data {
+    struct sck_mpu6050_frame sample;    // 最近一次fetch的原始计数
+    uint8_t smplrt_div;                 // 当前采样率，recover后保持
+    uint32_t period_ns;
+    uint64_t next_ts_ns;                // 下一个FIFO样本允许的最早时间戳（批间单调）
+    uint8_t mot_thr;                    // 运动检测阈值/持续时间（寄存器值）
+    uint8_t mot_dur;
+    bool low_power;                     // 低功耗周期模式，只做运动检测
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    atomic_t bus_resumes;               // 访问芯片时总线处于挂起、被唤醒的次数
+    atomic_t bus_suspends;              // 释放后总线挂起的次数
+#endif
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+    const struct device *dev;
+    struct gpio_callback gpio_cb;
+    struct k_work trig_work;
+    struct k_work motion_work;
+    atomic_t drdy_count;
+    sensor_trigger_handler_t drdy_handler;
+    const struct sensor_trigger *drdy_trigger;
+    sensor_trigger_handler_t motion_handler;
+    const struct sensor_trigger *motion_trigger;
+#endif
+#ifdef CONFIG_SENSOR_ASYNC_API
+    struct k_work async_work;
+    struct rtio_iodev_sqe *pending;
+    const struct device *async_dev;
+    struct k_spinlock lock;
+#endif
+};
+
+// 异步读取的结果缓冲格式（decoder解析）
+struct sck_mpu6050_encoded {
+    uint64_t timestamp_ns;              // 第一个样本的时间
+    uint32_t period_ns;
+    uint16_t count;
+    uint8_t overflow;                   // 本次读取前FIFO溢出过，序号已重新对齐
+    uint8_t reserved;
+    struct sck_mpu6050_frame frames[];
+};
+
+BUILD_ASSERT(sizeof(struct sck_mpu6050_encoded) == SCK_MPU6050_ENCODED_HDR_SIZE, "encoded header");
+
+// 芯片复位并按设备树配置采样率/FIFO
+int sck_mpu6050_configure(const struct device *dev);
+// 读出FIFO中至多max帧，溢出时复位FIFO并置 *overflow，返回帧数或负错误码
+int sck_mpu6050_fifo_read(const struct device *dev, struct sck_mpu6050_frame *out, int max,
+                          bool *overflow);
+// 一次14字节burst读出最新的加速度、温度和陀螺仪
+int sck_mpu6050_read_frame(const struct device *dev, struct sck_mpu6050_frame *out);
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+// 访问芯片前取得I2C控制器（挂起时唤醒），结束后释放，没有其他用户时控制器挂起。
+// 可嵌套，一次FIFO读取的几次传输只唤醒一次总线
+int sck_mpu6050_bus_get(const struct device *dev);
+void sck_mpu6050_bus_put(const struct device *dev);
+#else
+static inline int sck_mpu6050_bus_get(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+    return 0;
+}
+
+static inline void sck_mpu6050_bus_put(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+}
+#endif
+// 中断回调和异步读取共用的驱动工作队列
+struct k_work_q *sck_mpu6050_workq(void);
+// 当前模式下应打开的中断：正常模式为数据就绪/FIFO溢出，低功耗模式为运动检测
+uint8_t sck_mpu6050_int_mask(const struct device *dev);
+
+#ifdef CONFIG_SCK_MPU6050_TRIGGER
+int sck_mpu6050_trigger_init(const struct device *dev);
+int sck_mpu6050_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                            sensor_trigger_handler_t handler);
+#endif
+
+#ifdef CONFIG_SENSOR_ASYNC_API
+void sck_mpu6050_async_init(const struct device *dev);
+void sck_mpu6050_submit(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe);
+int sck_mpu6050_get_decoder(const struct device *dev, const struct sensor_decoder_api **decoder);
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+#include "sck_mpu6050.h"
+#include <zephyr/logging/log.h>
+#include <zephyr/rtio/rtio.h>
+
+LOG_MODULE_DECLARE(sck_mpu6050, CONFIG_SENSOR_LOG_LEVEL);
+
+// 异步读取：submit只登记请求，I2C传输在驱动工作队列里完成后再完成RTIO请求，
+// 调用线程可以在传输期间处理上一批数据。同一时间只允许一个请求在途。
+// 不论请求哪些通道都读整帧（加速度+温度+陀螺仪），decoder按通道取用。
+
+static bool chan_supported(uint16_t type)
+{
+    switch (type) {
+    case SENSOR_CHAN_ALL:
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+    case SENSOR_CHAN_ACCEL_XYZ:
+    case SENSOR_CHAN_GYRO_X:
+    case SENSOR_CHAN_GYRO_Y:
+    case SENSOR_CHAN_GYRO_Z:
+    case SENSOR_CHAN_GYRO_XYZ:
+    case SENSOR_CHAN_DIE_TEMP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static int async_read(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    const struct sensor_read_config *read_cfg = iodev_sqe->sqe.iodev->data;
+    struct sck_mpu6050_encoded *enc;
+    int max_frames = cfg->fifo_watermark ? cfg->fifo_watermark * 2 : 1;
+    uint8_t *buf;
+    uint32_t buf_len;
+    int ret;
+
+    for (size_t i = 0; i < read_cfg->count; i++) {
+        if (!chan_supported(read_cfg->channels[i].chan_type)) {
+            return -ENOTSUP;
+        }
+    }
+
+    ret = rtio_sqe_rx_buf(iodev_sqe, sizeof(*enc) + MPU6050_SAMPLE_BYTES,
+                          sizeof(*enc) + max_frames * MPU6050_SAMPLE_BYTES, &buf, &buf_len);
+    if (ret != 0) {
+        return ret;
+    }
+    enc = (struct sck_mpu6050_encoded *)buf;
+    max_frames = MIN(max_frames, (int)((buf_len - sizeof(*enc)) / MPU6050_SAMPLE_BYTES));
+    enc->period_ns = data->period_ns;
+    enc->overflow = 0;
+    enc->reserved = 0;
+
+    if (!cfg->fifo_watermark) {
+        ret = sck_mpu6050_read_frame(dev, &enc->frames[0]);
+        enc->count = 1;
+        enc->timestamp_ns = k_ticks_to_ns_floor64(k_uptime_ticks());
+        return ret;
+    }
+
+    bool overflow;
+    int n = sck_mpu6050_fifo_read(dev, enc->frames, max_frames, &overflow);
+    if (n < 0) {
+        return n;
+    }
+
+    // 每批按读完时刻重新对齐到 k_uptime：最后一帧记为读完时间，向前按周期倒推。
+    // 只靠序号累加会和 k_uptime 逐渐漂移（芯片时钟与系统时钟不同源）；
+    // 对齐后若与上一批重叠则顺延，保证时间戳单调
+    uint64_t now_ns = k_ticks_to_ns_floor64(k_uptime_ticks());
+    uint64_t span_ns = n > 0 ? (uint64_t)(n - 1) * data->period_ns : 0;
+    uint64_t first_ns = now_ns > span_ns ? now_ns - span_ns : 0;
+
+    if (!overflow && first_ns < data->next_ts_ns) {
+        first_ns = data->next_ts_ns;
+    }
+    if (n > 0) {
+        data->next_ts_ns = first_ns + span_ns + data->period_ns;
+    }
+    enc->count = (uint16_t)n;
+    enc->overflow = overflow;
+    enc->timestamp_ns = first_ns;
+    return 0;
+}
+
+static void sck_mpu6050_async_work(struct k_work *work)
+{
+    struct sck_mpu6050_data *data = CONTAINER_OF(work, struct sck_mpu6050_data, async_work);
+    struct rtio_iodev_sqe *iodev_sqe = data->pending;
+    int ret = async_read(data->async_dev, iodev_sqe);
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    data->pending = NULL;
+    k_spin_unlock(&data->lock, key);
+
+    if (ret < 0) {
+        rtio_iodev_sqe_err(iodev_sqe, ret);
+    } else {
+        rtio_iodev_sqe_ok(iodev_sqe, 0);
+    }
+}
+
+void sck_mpu6050_submit(const struct device *dev, struct rtio_iodev_sqe *iodev_sqe)
+{
+    struct sck_mpu6050_data *data = dev->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    if (data->pending) {
+        k_spin_unlock(&data->lock, key);
+        rtio_iodev_sqe_err(iodev_sqe, -EBUSY);
+        return;
+    }
+    data->pending = iodev_sqe;
+    k_spin_unlock(&data->lock, key);
+
+    k_work_submit_to_queue(sck_mpu6050_workq(), &data->async_work);
+}
+
+void sck_mpu6050_async_init(const struct device *dev)
+{
+    struct sck_mpu6050_data *data = dev->data;
+
+    data->async_dev = dev;
+    k_work_init(&data->async_work, sck_mpu6050_async_work);
+}
@@ -0,0 +1,153 @@
+#define DT_DRV_COMPAT sck_mpu6050
+
+#include "sck_mpu6050.h"
+#include <drivers/sck_mpu6050.h>
+
+// 解析 sck_mpu6050_encoded：加速度 shift = SCK_MPU6050_Q31_SHIFT (m/s^2)，
+// 陀螺仪 shift = SCK_MPU6050_GYRO_Q31_SHIFT (rad/s)，温度 shift = SCK_MPU6050_TEMP_Q31_SHIFT (°C)
+
+enum chan_kind { KIND_NONE, KIND_ACCEL, KIND_GYRO, KIND_TEMP };
+
+static enum chan_kind chan_kind(uint16_t type)
+{
+    switch (type) {
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+    case SENSOR_CHAN_ACCEL_XYZ:
+        return KIND_ACCEL;
+    case SENSOR_CHAN_GYRO_X:
+    case SENSOR_CHAN_GYRO_Y:
+    case SENSOR_CHAN_GYRO_Z:
+    case SENSOR_CHAN_GYRO_XYZ:
+        return KIND_GYRO;
+    case SENSOR_CHAN_DIE_TEMP:
+        return KIND_TEMP;
+    default:
+        return KIND_NONE;
+    }
+}
+
+static inline int32_t temp_to_q31(int16_t counts)
+{
+    // (counts / 340 + 36.53) * 2^(31 - 8)
+    return (int32_t)(((int64_t)counts << 23) / MPU6050_TEMP_COUNTS_PER_C +
+                     ((int64_t)MPU6050_TEMP_OFFSET_MC << 23) / 1000);
+}
+
+static int decoder_get_frame_count(const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+                                   uint16_t *frame_count)
+{
+    const struct sck_mpu6050_encoded *enc = (const struct sck_mpu6050_encoded *)buffer;
+
+    if (chan_spec.chan_idx != 0 || chan_kind(chan_spec.chan_type) == KIND_NONE) {
+        return -ENOTSUP;
+    }
+    *frame_count = enc->count;
+    return 0;
+}
+
+static int decoder_get_size_info(struct sensor_chan_spec chan_spec, size_t *base_size,
+                                 size_t *frame_size)
+{
+    switch (chan_spec.chan_type) {
+    case SENSOR_CHAN_ACCEL_XYZ:
+    case SENSOR_CHAN_GYRO_XYZ:
+        *base_size = sizeof(struct sensor_three_axis_data);
+        *frame_size = sizeof(struct sensor_three_axis_sample_data);
+        return 0;
+    case SENSOR_CHAN_ACCEL_X:
+    case SENSOR_CHAN_ACCEL_Y:
+    case SENSOR_CHAN_ACCEL_Z:
+    case SENSOR_CHAN_GYRO_X:
+    case SENSOR_CHAN_GYRO_Y:
+    case SENSOR_CHAN_GYRO_Z:
+    case SENSOR_CHAN_DIE_TEMP:
+        *base_size = sizeof(struct sensor_q31_data);
+        *frame_size = sizeof(struct sensor_q31_sample_data);
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+// readings[].timestamp_delta 是相对本次调用基准时间的32位ns，
+// 低采样率下一次只解码差值放得下的帧数，其余帧由下一次调用（新的基准时间）给出
+static uint16_t frames_per_call(uint32_t period_ns)
+{
+    return period_ns ? (uint16_t)MIN(UINT16_MAX, UINT32_MAX / period_ns + 1) : UINT16_MAX;
+}
+
+static int decoder_decode(const uint8_t *buffer, struct sensor_chan_spec chan_spec,
+                          uint32_t *fit, uint16_t max_count, void *data_out)
+{
+    const struct sck_mpu6050_encoded *enc = (const struct sck_mpu6050_encoded *)buffer;
+    uint64_t base_ns = enc->timestamp_ns + (uint64_t)*fit * enc->period_ns;
+    enum chan_kind kind = chan_kind(chan_spec.chan_type);
+    bool gyro = kind == KIND_GYRO;
+    int32_t per_count = gyro ? SCK_MPU6050_GYRO_Q31_PER_COUNT : SCK_MPU6050_Q31_PER_COUNT;
+    int8_t shift = gyro ? SCK_MPU6050_GYRO_Q31_SHIFT : SCK_MPU6050_Q31_SHIFT;
+    int count = 0;
+
+    if (chan_spec.chan_idx != 0 || kind == KIND_NONE) {
+        return -ENOTSUP;
+    }
+    if (*fit >= enc->count) {
+        return 0;
+    }
+    max_count = MIN(max_count, frames_per_call(enc->period_ns));
+
+    if (chan_spec.chan_type == SENSOR_CHAN_ACCEL_XYZ || chan_spec.chan_type == SENSOR_CHAN_GYRO_XYZ) {
+        struct sensor_three_axis_data *out = data_out;
+
+        out->header.base_timestamp_ns = base_ns;
+        out->shift = shift;
+        for (; *fit < enc->count && count < max_count; (*fit)++, count++) {
+            const struct sck_mpu6050_frame *f = &enc->frames[*fit];
+            const int16_t *xyz = gyro ? f->gyro : f->accel;
+
+            out->readings[count].timestamp_delta = (uint32_t)((uint64_t)count * enc->period_ns);
+            for (int i = 0; i < 3; i++) {
+                out->readings[count].values[i] = xyz[i] * per_count;
+            }
+        }
+        out->header.reading_count = count;
+    } else {
+        struct sensor_q31_data *out = data_out;
+        int axis = gyro ? chan_spec.chan_type - SENSOR_CHAN_GYRO_X :
+                          chan_spec.chan_type - SENSOR_CHAN_ACCEL_X;
+
+        out->header.base_timestamp_ns = base_ns;
+        out->shift = kind == KIND_TEMP ? SCK_MPU6050_TEMP_Q31_SHIFT : shift;
+        for (; *fit < enc->count && count < max_count; (*fit)++, count++) {
+            const struct sck_mpu6050_frame *f = &enc->frames[*fit];
+
+            out->readings[count].timestamp_delta = (uint32_t)((uint64_t)count * enc->period_ns);
+            out->readings[count].value = kind == KIND_TEMP ? temp_to_q31(f->temp) :
+                                         (gyro ? f->gyro : f->accel)[axis] * per_count;
+        }
+        out->header.reading_count = count;
+    }
+    return count;
+}
+
+static bool decoder_has_trigger(const uint8_t *buffer, enum sensor_trigger_type trigger)
+{
+    ARG_UNUSED(buffer);
+    ARG_UNUSED(trigger);
+    return false;
+}
+
+SENSOR_DECODER_API_DT_DEFINE() = {
+    .get_frame_count = decoder_get_frame_count,
+    .get_size_info = decoder_get_size_info,
+    .decode = decoder_decode,
+    .has_trigger = decoder_has_trigger,
+};
+
+int sck_mpu6050_get_decoder(const struct device *dev, const struct sensor_decoder_api **decoder)
+{
+    ARG_UNUSED(dev);
+    *decoder = &SENSOR_DECODER_NAME();
+    return 0;
+}
@@ -0,0 +1,408 @@
+#define DT_DRV_COMPAT sck_mpu6050
+
+// MPU6050 I2C 仿真器：寄存器文件 + 按时间产生样本的1024字节FIFO。
+// 支持低功耗周期模式下的运动检测中断（相邻两次周期采样之差超过 MOT_THR）。
+// 样本来自 .sckt 录制文件（native_sim 下从主机读取，格式见 tools/common/trace_io.h），
+// 没有配置文件时产生合成数据（静止 + 每3秒一次双击）。录制文件只有加速度，
+// 陀螺仪输出0、温度固定25°C；FIFO只支持驱动使用的整帧配置（MPU6050_FIFO_EN_ALL）。
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#ifdef CONFIG_GPIO_EMUL
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#endif
+#ifdef CONFIG_ARCH_POSIX
+#include <nsi_host_trampolines.h>
+#endif
+
+#include "sck_mpu6050.h"
+
+LOG_MODULE_DECLARE(sck_mpu6050, CONFIG_SENSOR_LOG_LEVEL);
+
+#define EMUL_FIFO_SAMPLES   (MPU6050_FIFO_SIZE / MPU6050_SAMPLE_BYTES)
+#define EMUL_PWR_SLEEP      0x40
+#define EMUL_SYNTH_PERIOD   150         // 合成数据周期（样本）
+#define EMUL_SYNTH_TAP      12000       // 合成敲击幅度（计数）
+#define EMUL_TEMP_25C       (-3920)     // (25 - 36.53) * 340
+
+#define SCKT_HDR_SIZE       20
+#define SCKT_REC_SIZE       8
+
+struct mpu6050_emul_cfg {
+    struct gpio_dt_spec int_gpio;
+};
+
+struct mpu6050_emul_data {
+    uint8_t regs[128];
+    struct sck_mpu6050_frame fifo[EMUL_FIFO_SAMPLES];
+    int fifo_head, fifo_cnt;
+    int fifo_byte;                      // 队头样本已读出的字节数
+    struct sck_mpu6050_frame latest;
+    int16_t mot_ref[3];                 // 上一次低功耗周期采样
+    int64_t t_start_us;
+    int64_t produced;
+    uint32_t trace_pos;
+    struct k_timer int_timer;           // 数据就绪脉冲 / 低功耗周期唤醒
+    struct k_spinlock lock;             // I2C访问与定时器回调互斥
+    const struct mpu6050_emul_cfg *cfg;
+};
+
+// 所有实例共用一份录制数据
+static int16_t trace_xyz[CONFIG_SCK_MPU6050_EMUL_TRACE_MAX][3];
+static uint32_t trace_len;
+
+static int64_t now_us(void)
+{
+    return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static uint32_t sample_period_us(const struct mpu6050_emul_data *d)
+{
+    uint32_t base_hz = (d->regs[MPU6050_REG_CONFIG] & 0x07) ? 1000 : 8000;
+
+    return (1 + d->regs[MPU6050_REG_SMPLRT_DIV]) * 1000000 / base_hz;
+}
+
+static bool cycle_mode(const struct mpu6050_emul_data *d)
+{
+    return (d->regs[MPU6050_REG_PWR_MGMT_1] & (MPU6050_PWR_CYCLE | EMUL_PWR_SLEEP)) ==
+           MPU6050_PWR_CYCLE;
+}
+
+static uint32_t lp_period_us(const struct mpu6050_emul_data *d)
+{
+    static const uint32_t period_us[] = {800000, 200000, 50000, 25000};   // 1.25/5/20/40Hz
+
+    return period_us[d->regs[MPU6050_REG_PWR_MGMT_2] >> MPU6050_PWR2_LP_WAKE_SHIFT];
+}
+
+static bool fifo_enabled(const struct mpu6050_emul_data *d)
+{
+    return (d->regs[MPU6050_REG_USER_CTRL] & MPU6050_USER_FIFO_EN) &&
+           d->regs[MPU6050_REG_FIFO_EN] == MPU6050_FIFO_EN_ALL;
+}
+
+static void fifo_clear(struct mpu6050_emul_data *d)
+{
+    d->fifo_head = 0;
+    d->fifo_cnt = 0;
+    d->fifo_byte = 0;
+}
+
+static void timebase_reset(struct mpu6050_emul_data *d)
+{
+    d->t_start_us = now_us();
+    d->produced = 0;
+}
+
+static void next_sample(struct mpu6050_emul_data *d, struct sck_mpu6050_frame *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->temp = EMUL_TEMP_25C;
+
+    if (trace_len) {
+        memcpy(out->accel, trace_xyz[d->trace_pos], sizeof(trace_xyz[0]));
+        d->trace_pos = (d->trace_pos + 1) % trace_len;
+        return;
+    }
+
+    int k = d->produced % EMUL_SYNTH_PERIOD;
+    out->accel[2] = MPU6050_COUNTS_PER_G;
+    if (k == EMUL_SYNTH_PERIOD / 2 || k == EMUL_SYNTH_PERIOD / 2 + 10) {
+        out->accel[2] += EMUL_SYNTH_TAP;
+    }
+}
+
+static void fifo_push(struct mpu6050_emul_data *d, const struct sck_mpu6050_frame *s)
+{
+    if (d->fifo_cnt == EMUL_FIFO_SAMPLES) {
+        // 与芯片一致：满了覆盖最旧的数据
+        d->fifo_head = (d->fifo_head + 1) % EMUL_FIFO_SAMPLES;
+        d->fifo_cnt--;
+        d->fifo_byte = 0;
+        d->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_FIFO_OFLOW;
+    }
+    d->fifo[(d->fifo_head + d->fifo_cnt) % EMUL_FIFO_SAMPLES] = *s;
+    d->fifo_cnt++;
+}
+
+// 补齐从上次访问到现在应产生的样本
+static void emul_advance(struct mpu6050_emul_data *d)
+{
+    if (d->regs[MPU6050_REG_PWR_MGMT_1] & EMUL_PWR_SLEEP) {
+        return;
+    }
+
+    int64_t due = (now_us() - d->t_start_us) / sample_period_us(d);
+    int64_t skip = due - d->produced - (EMUL_FIFO_SAMPLES + 1);
+    if (skip > 0) {
+        // 长时间没访问，只保留能装进FIFO的最新样本
+        d->produced += skip;
+        if (trace_len) {
+            d->trace_pos = (d->trace_pos + skip) % trace_len;
+        }
+        if (fifo_enabled(d)) {
+            d->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_FIFO_OFLOW;
+        }
+    }
+
+    while (d->produced < due) {
+        next_sample(d, &d->latest);
+        if (fifo_enabled(d)) {
+            fifo_push(d, &d->latest);
+        }
+        d->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_DATA_RDY;
+        d->produced++;
+    }
+}
+
+static uint8_t fifo_pop_byte(struct mpu6050_emul_data *d)
+{
+    if (d->fifo_cnt == 0) {
+        return 0;
+    }
+
+    uint16_t v = (uint16_t)((const int16_t *)&d->fifo[d->fifo_head])[d->fifo_byte / 2];
+    uint8_t b = (d->fifo_byte & 1) ? (uint8_t)v : (uint8_t)(v >> 8);
+
+    if (++d->fifo_byte == MPU6050_SAMPLE_BYTES) {
+        d->fifo_byte = 0;
+        d->fifo_head = (d->fifo_head + 1) % EMUL_FIFO_SAMPLES;
+        d->fifo_cnt--;
+    }
+    return b;
+}
+
+static uint8_t emul_read_reg(struct mpu6050_emul_data *d, uint8_t reg)
+{
+    int fifo_bytes = d->fifo_cnt * MPU6050_SAMPLE_BYTES - d->fifo_byte;
+
+    switch (reg) {
+    case MPU6050_REG_INT_STATUS: {
+        uint8_t v = d->regs[reg];
+        d->regs[reg] = 0;               // 读清除
+        return v;
+    }
+    case MPU6050_REG_ACCEL_XOUT_H ... MPU6050_REG_ACCEL_XOUT_H + MPU6050_SAMPLE_BYTES - 1: {
+        int idx = reg - MPU6050_REG_ACCEL_XOUT_H;
+        uint16_t v = (uint16_t)((const int16_t *)&d->latest)[idx / 2];
+        return (idx & 1) ? (uint8_t)v : (uint8_t)(v >> 8);
+    }
+    case MPU6050_REG_FIFO_COUNT_H:
+        return (uint8_t)(fifo_bytes >> 8);
+    case MPU6050_REG_FIFO_COUNT_H + 1:
+        return (uint8_t)fifo_bytes;
+    case MPU6050_REG_FIFO_R_W:
+        return fifo_pop_byte(d);
+    case MPU6050_REG_WHO_AM_I:
+        return MPU6050_WHO_AM_I_VAL;
+    default:
+        return d->regs[reg];
+    }
+}
+
+static void int_timer_update(struct mpu6050_emul_data *d)
+{
+    uint8_t en = d->regs[MPU6050_REG_INT_ENABLE];
+    uint32_t us = 0;
+
+    if (d->cfg->int_gpio.port && !(d->regs[MPU6050_REG_PWR_MGMT_1] & EMUL_PWR_SLEEP)) {
+        if (cycle_mode(d)) {
+            us = (en & MPU6050_INT_MOT) ? lp_period_us(d) : 0;
+        } else if (en & MPU6050_INT_DATA_RDY) {
+            us = sample_period_us(d);
+        }
+    }
+
+    if (us) {
+        k_timer_start(&d->int_timer, K_USEC(us), K_USEC(us));
+    } else {
+        k_timer_stop(&d->int_timer);
+    }
+}
+
+static void emul_write_reg(struct mpu6050_emul_data *d, uint8_t reg, uint8_t val)
+{
+    switch (reg) {
+    case MPU6050_REG_PWR_MGMT_1:
+        if (val & MPU6050_PWR_RESET) {
+            memset(d->regs, 0, sizeof(d->regs));
+            d->regs[reg] = EMUL_PWR_SLEEP;
+            fifo_clear(d);
+        } else {
+            d->regs[reg] = val;
+            timebase_reset(d);
+            memcpy(d->mot_ref, d->latest.accel, sizeof(d->mot_ref));
+        }
+        int_timer_update(d);
+        break;
+    case MPU6050_REG_USER_CTRL:
+        if (val & MPU6050_USER_FIFO_RESET) {
+            fifo_clear(d);
+            d->regs[MPU6050_REG_INT_STATUS] &= ~MPU6050_INT_FIFO_OFLOW;
+        }
+        d->regs[reg] = val & ~0x07;     // 复位位自清除
+        break;
+    case MPU6050_REG_CONFIG:
+    case MPU6050_REG_SMPLRT_DIV:
+        d->regs[reg] = val;
+        timebase_reset(d);
+        int_timer_update(d);
+        break;
+    case MPU6050_REG_INT_ENABLE:
+    case MPU6050_REG_PWR_MGMT_2:
+        d->regs[reg] = val;
+        int_timer_update(d);
+        break;
+    default:
+        d->regs[reg] = val;
+        break;
+    }
+}
+
+// FIFO_R_W 连续读不自增地址，其余寄存器自增
+static uint8_t next_reg(uint8_t reg)
+{
+    return reg == MPU6050_REG_FIFO_R_W ? reg : (uint8_t)((reg + 1) & 0x7F);
+}
+
+static int mpu6050_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+                                 int addr)
+{
+    struct mpu6050_emul_data *d = target->data;
+
+    ARG_UNUSED(addr);
+
+    if (num_msgs < 1 || msgs[0].len < 1 || (msgs[0].flags & I2C_MSG_READ)) {
+        return -EIO;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&d->lock);
+    emul_advance(d);
+
+    uint8_t reg = msgs[0].buf[0] & 0x7F;
+    for (uint32_t i = 1; i < msgs[0].len; i++, reg = next_reg(reg)) {
+        emul_write_reg(d, reg, msgs[0].buf[i]);
+    }
+    for (int m = 1; m < num_msgs; m++) {
+        for (uint32_t i = 0; i < msgs[m].len; i++, reg = next_reg(reg)) {
+            if (msgs[m].flags & I2C_MSG_READ) {
+                msgs[m].buf[i] = emul_read_reg(d, reg);
+            } else {
+                emul_write_reg(d, reg, msgs[m].buf[i]);
+            }
+        }
+    }
+    k_spin_unlock(&d->lock, key);
+    return 0;
+}
+
+// 低功耗模式下做一次运动检测，返回是否触发
+static bool motion_check(struct mpu6050_emul_data *d)
+{
+    int32_t th = d->regs[MPU6050_REG_MOT_THR] * MPU6050_MOT_THR_MG_PER_LSB *
+                 MPU6050_COUNTS_PER_G / 1000;
+    bool motion = false;
+
+    emul_advance(d);
+    for (int i = 0; i < 3; i++) {
+        int32_t diff = d->latest.accel[i] - d->mot_ref[i];
+        motion |= (diff < 0 ? -diff : diff) > th;
+    }
+    memcpy(d->mot_ref, d->latest.accel, sizeof(d->mot_ref));
+    if (motion) {
+        d->regs[MPU6050_REG_INT_STATUS] |= MPU6050_INT_MOT;
+    }
+    return motion;
+}
+
+// INT引脚：正常模式每个采样周期一个数据就绪脉冲，低功耗模式检测到运动才拉脉冲
+static void int_timer_expiry(struct k_timer *timer)
+{
+    struct mpu6050_emul_data *d = k_timer_user_data_get(timer);
+    k_spinlock_key_t key = k_spin_lock(&d->lock);
+    bool pulse = cycle_mode(d) ? motion_check(d) : true;
+
+    k_spin_unlock(&d->lock, key);
+
+#ifdef CONFIG_GPIO_EMUL
+    if (pulse) {
+        const struct gpio_dt_spec *pin = &d->cfg->int_gpio;
+
+        gpio_emul_input_set(pin->port, pin->pin, 1);
+        gpio_emul_input_set(pin->port, pin->pin, 0);
+    }
+#else
+    ARG_UNUSED(pulse);
+#endif
+}
+
+#ifdef CONFIG_ARCH_POSIX
+static void load_trace(const char *path)
+{
+    uint8_t hdr[SCKT_HDR_SIZE];
+    uint8_t rec[SCKT_REC_SIZE];
+    int fd = nsi_host_open(path, 0 /* O_RDONLY */);
+
+    if (fd < 0) {
+        LOG_WRN("trace %s not found, using synthetic data", path);
+        return;
+    }
+    if (nsi_host_read(fd, hdr, sizeof(hdr)) != sizeof(hdr) || memcmp(hdr, "SCKT", 4) != 0 ||
+        sys_get_le16(&hdr[6]) != SCKT_REC_SIZE) {
+        LOG_WRN("%s: not a .sckt trace", path);
+        nsi_host_close(fd);
+        return;
+    }
+
+    uint32_t count = MIN(sys_get_le32(&hdr[8]), CONFIG_SCK_MPU6050_EMUL_TRACE_MAX);
+    for (trace_len = 0; trace_len < count; trace_len++) {
+        if (nsi_host_read(fd, rec, sizeof(rec)) != sizeof(rec)) {
+            break;
+        }
+        for (int i = 0; i < 3; i++) {
+            trace_xyz[trace_len][i] = (int16_t)sys_get_le16(&rec[2 * i]);
+        }
+    }
+    nsi_host_close(fd);
+    LOG_INF("%s: %u samples", path, trace_len);
+}
+#endif
+
+static int mpu6050_emul_init(const struct emul *target, const struct device *parent)
+{
+    struct mpu6050_emul_data *d = target->data;
+
+    ARG_UNUSED(parent);
+
+    d->cfg = target->cfg;
+    d->regs[MPU6050_REG_PWR_MGMT_1] = EMUL_PWR_SLEEP;
+    k_timer_init(&d->int_timer, int_timer_expiry, NULL);
+    k_timer_user_data_set(&d->int_timer, d);
+
+#ifdef CONFIG_ARCH_POSIX
+    if (trace_len == 0 && CONFIG_SCK_MPU6050_EMUL_TRACE[0] != '\0') {
+        load_trace(CONFIG_SCK_MPU6050_EMUL_TRACE);
+    }
+#endif
+    return 0;
+}
+
+static const struct i2c_emul_api mpu6050_emul_api = {
+    .transfer = mpu6050_emul_transfer,
+};
+
+#define MPU6050_EMUL(n)                                                                 \
+    static struct mpu6050_emul_data mpu6050_emul_data_##n;                              \
+    static const struct mpu6050_emul_cfg mpu6050_emul_cfg_##n = {                       \
+        .int_gpio = GPIO_DT_SPEC_INST_GET_OR(n, int_gpios, {0}),                        \
+    };                                                                                  \
+    EMUL_DT_INST_DEFINE(n, mpu6050_emul_init, &mpu6050_emul_data_##n,                   \
+                        &mpu6050_emul_cfg_##n, &mpu6050_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(MPU6050_EMUL)
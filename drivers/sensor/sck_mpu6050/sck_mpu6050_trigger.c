@@ -0,0 +1,101 @@
+#include "sck_mpu6050.h"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(sck_mpu6050, CONFIG_SENSOR_LOG_LEVEL);
+
+// 中断里只计数，累计到水位（无FIFO时每个样本）才把回调交给驱动工作队列；
+// 低功耗模式下INT只会是运动中断
+static void sck_mpu6050_gpio_callback(const struct device *port, struct gpio_callback *cb,
+                                      uint32_t pins)
+{
+    struct sck_mpu6050_data *data = CONTAINER_OF(cb, struct sck_mpu6050_data, gpio_cb);
+    const struct sck_mpu6050_config *cfg = data->dev->config;
+    int watermark = cfg->fifo_watermark ? cfg->fifo_watermark : 1;
+
+    ARG_UNUSED(port);
+    ARG_UNUSED(pins);
+
+    if (data->low_power) {
+        k_work_submit_to_queue(sck_mpu6050_workq(), &data->motion_work);
+    } else if (atomic_inc(&data->drdy_count) + 1 >= watermark) {
+        atomic_set(&data->drdy_count, 0);
+        k_work_submit_to_queue(sck_mpu6050_workq(), &data->trig_work);
+    }
+}
+
+static void sck_mpu6050_trig_work(struct k_work *work)
+{
+    struct sck_mpu6050_data *data = CONTAINER_OF(work, struct sck_mpu6050_data, trig_work);
+    sensor_trigger_handler_t handler = data->drdy_handler;
+
+    if (handler) {
+        handler(data->dev, data->drdy_trigger);
+    }
+}
+
+static void sck_mpu6050_motion_work(struct k_work *work)
+{
+    struct sck_mpu6050_data *data = CONTAINER_OF(work, struct sck_mpu6050_data, motion_work);
+    sensor_trigger_handler_t handler = data->motion_handler;
+
+    if (handler) {
+        handler(data->dev, data->motion_trigger);
+    }
+}
+
+int sck_mpu6050_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                            sensor_trigger_handler_t handler)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    int ret;
+
+    if (!cfg->int_gpio.port ||
+        (trig->type != SENSOR_TRIG_DATA_READY && trig->type != SENSOR_TRIG_MOTION)) {
+        return -ENOTSUP;
+    }
+
+    gpio_pin_interrupt_configure_dt(&cfg->int_gpio, GPIO_INT_DISABLE);
+    if (trig->type == SENSOR_TRIG_DATA_READY) {
+        data->drdy_handler = handler;
+        data->drdy_trigger = trig;
+        atomic_set(&data->drdy_count, 0);
+    } else {
+        data->motion_handler = handler;
+        data->motion_trigger = trig;
+    }
+
+    ret = sck_mpu6050_bus_get(dev);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = i2c_reg_write_byte_dt(&cfg->i2c, MPU6050_REG_INT_ENABLE, sck_mpu6050_int_mask(dev));
+    sck_mpu6050_bus_put(dev);
+    if (ret != 0 || (!data->drdy_handler && !data->motion_handler)) {
+        return ret;
+    }
+    return gpio_pin_interrupt_configure_dt(&cfg->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+}
+
+int sck_mpu6050_trigger_init(const struct device *dev)
+{
+    const struct sck_mpu6050_config *cfg = dev->config;
+    struct sck_mpu6050_data *data = dev->data;
+    int ret;
+
+    if (!gpio_is_ready_dt(&cfg->int_gpio)) {
+        LOG_ERR("INT gpio not ready");
+        return -ENODEV;
+    }
+
+    data->dev = dev;
+    k_work_init(&data->trig_work, sck_mpu6050_trig_work);
+    k_work_init(&data->motion_work, sck_mpu6050_motion_work);
+
+    ret = gpio_pin_configure_dt(&cfg->int_gpio, GPIO_INPUT);
+    if (ret != 0) {
+        return ret;
+    }
+    gpio_init_callback(&data->gpio_cb, sck_mpu6050_gpio_callback, BIT(cfg->int_gpio.pin));
+    return gpio_add_callback(cfg->int_gpio.port, &data->gpio_cb);
+}
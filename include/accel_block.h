@@ -0,0 +1,35 @@
+#ifndef ACCEL_BLOCK_H
+#define ACCEL_BLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 批量样本的模长内核：纯C实现，不依赖Zephyr，固件、基准和主机回放共用。
+//
+// 输入为交错存放的int16三轴样本（ax,ay,az相邻），stride为相邻样本的字节距离，
+// 可以直接作用于 AccelSample/ImuSample 数组。带DSP扩展的内核（Cortex-M33等，
+// __ARM_FEATURE_SIMD32）用SMUAD/SMLABB一次算两轴平方和，其余平台用C实现，
+// 两者结果逐位一致。开方以前一个样本的模长为初值做牛顿迭代，再修正到向下取整，
+// 结果与逐位开方相同；相邻样本模长接近时一两次迭代即可。
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#define ACCEL_BLOCK_SIMD    1
+#else
+#define ACCEL_BLOCK_SIMD    0
+#endif
+
+#define ACCEL_MAG_MAX       56755   // 三轴都取-32768时的模长（计数，向下取整）
+
+// 逐位整数开方，结果向下取整
+uint32_t accel_isqrt(uint32_t v);
+// 以seed为初值开方，结果与 accel_isqrt 相同；seed为0或与结果相差超过一倍时退回逐位开方
+uint32_t accel_isqrt_seeded(uint32_t v, uint32_t seed);
+
+// 三轴平方和，最大3*2^30，不会溢出uint32
+void accel_block_mag_sq(const int16_t *xyz, size_t stride, int n, uint32_t *out);
+// n个样本的模长(计数)，seed为前一个样本的模长（没有时传0）
+void accel_block_mag(const int16_t *xyz, size_t stride, int n, int32_t seed, int32_t *mag);
+// 逐样本C实现（平方和 + 逐位开方），基准对比和结果校验用
+void accel_block_mag_ref(const int16_t *xyz, size_t stride, int n, int32_t *mag);
+
+#endif
@@ -1,4 +1,5 @@
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifndef BUTTON_INPUT_H
 #define BUTTON_INPUT_H
@@ -11,10 +12,30 @@ typedef enum {
     BUTTON_NUM
 } button_index_t;
 
-// 生产级: 每个按钮都传入index
-typedef void (*button_event_cb_t)(button_index_t, bool pressed);
-// bool pressed: true为按下，false为松开（可做长按逻辑）
+typedef enum {
+    BUTTON_EVT_PRESS = 0,       // 消抖后按下
+    BUTTON_EVT_RELEASE,         // 消抖后松开
+    BUTTON_EVT_CLICK,           // 单击（多击间隔超时后确认）
+    BUTTON_EVT_DOUBLE_CLICK,
+    BUTTON_EVT_TRIPLE_CLICK,
+    BUTTON_EVT_LONG_PRESS,      // 按住超过 BUTTON_LONG_PRESS_MS，之后的松开不计入单击
+} button_evt_type_t;
+
+typedef struct {
+    button_index_t index;
+    button_evt_type_t type;
+    int64_t timestamp_ms;       // 触发该事件的边沿时间（中断中记录）
+    uint32_t duration_ms;       // RELEASE/LONG_PRESS: 已按住的时长
+    uint8_t clicks;             // CLICK系列: 连击次数
+} button_event_t;
+
+#define BUTTON_DEBOUNCE_MS      20
+#define BUTTON_LONG_PRESS_MS    800
+#define BUTTON_MULTI_CLICK_MS   300     // 两次单击之间的最大间隔
+
+// 生产级: 每个按钮都传入index，事件在线程上下文（系统工作队列）中回调
+typedef void (*button_event_cb_t)(const button_event_t *evt);
 
 int button_input_init(button_event_cb_t cb);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,68 @@
+#ifndef SCK_MPU6050_H
+#define SCK_MPU6050_H
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <drivers/sck_mpu6050_scale.h>
+
+// SmartControlKit MPU6050 驱动（compatible "sck,mpu6050"）的扩展接口。
+//
+// 标准接口：sensor_sample_fetch/sensor_channel_get(SENSOR_CHAN_ACCEL_*/GYRO_*/DIE_TEMP)、
+// SENSOR_TRIG_DATA_READY 触发（每累计 fifo-watermark 个样本回调一次）、
+// SENSOR_TRIG_MOTION 运动唤醒（低功耗模式，见下）、
+// sensor_read_async_mempool 异步排空FIFO（decoder输出 q31，shift 见下）。
+// 每个样本是一帧14字节：加速度(±2g)、温度、陀螺仪(±1000°/s)，一次I2C传输读出。
+
+// 原始计数通道：一次返回三轴，val1为int16计数，val2为0
+enum sck_mpu6050_channel {
+    SENSOR_CHAN_SCK_MPU6050_RAW_XYZ = SENSOR_CHAN_PRIV_START,   // 加速度
+    SENSOR_CHAN_SCK_MPU6050_RAW_GYRO_XYZ,                       // 陀螺仪
+};
+
+// 异步读取缓冲：16字节头 + 每帧14字节
+#define SCK_MPU6050_ENCODED_HDR_SIZE    16
+#define SCK_MPU6050_READ_BUF_SIZE(n)    (SCK_MPU6050_ENCODED_HDR_SIZE + (n) * 14)
+
+// decoder输出的加速度 q31 定标：m/s^2 = q31 * 2^SHIFT / 2^31
+#define SCK_MPU6050_Q31_SHIFT       5
+// 每个计数对应的q31值：9.80665 * 2^31 / (16384 * 2^5)
+#define SCK_MPU6050_Q31_PER_COUNT   40168
+
+static inline int16_t sck_mpu6050_q31_to_counts(int32_t q)
+{
+    return (int16_t)(q / SCK_MPU6050_Q31_PER_COUNT);
+}
+
+// 陀螺仪：计数换算见 sck_mpu6050_scale.h；decoder输出 rad/s = q31 * 2^SHIFT / 2^31
+#define SCK_MPU6050_GYRO_Q31_SHIFT      5
+// 每个计数对应的q31值：(pi/180/32.8) * 2^31 / 2^5
+#define SCK_MPU6050_GYRO_Q31_PER_COUNT  35709
+
+static inline int16_t sck_mpu6050_gyro_q31_to_counts(int32_t q)
+{
+    return (int16_t)(q / SCK_MPU6050_GYRO_Q31_PER_COUNT);
+}
+
+// 芯片温度：°C = q31 * 2^SHIFT / 2^31
+#define SCK_MPU6050_TEMP_Q31_SHIFT      8
+
+// 低功耗周期模式：val1 为唤醒频率 1(1.25)/5/20/40 Hz，0 回到正常采样。
+// 低功耗模式下陀螺仪待机、FIFO关闭，只做运动检测：超过 SENSOR_ATTR_SLOPE_TH
+// （m/s^2，2mg分辨率）时触发 SENSOR_TRIG_MOTION。运动触发只在此模式下生效。
+enum sck_mpu6050_attribute {
+    SENSOR_ATTR_SCK_MPU6050_LOW_POWER = SENSOR_ATTR_PRIV_START,
+};
+
+// 采样率：SENSOR_ATTR_SAMPLING_FREQUENCY，val1 为Hz（4~1000，按 1kHz/(1+div) 取整），
+// 可在运行中切换，FIFO随之清空、时间戳按新周期重新对齐；需在两次异步读取之间调用，
+// 低功耗模式下返回 -EBUSY。上电默认值取设备树 smplrt-div。
+
+// 通信出错后重新复位并配置芯片（采样率、FIFO、中断使能按当前设置恢复）
+int sck_mpu6050_recover(const struct device *dev);
+
+// 开启 CONFIG_PM_DEVICE_RUNTIME 且I2C控制器启用了运行时PM（设备树
+// zephyr,pm-device-runtime-auto）时，驱动每次访问芯片前唤醒总线、结束后释放，
+// 两次读取之间总线挂起。返回唤醒和挂起的累计次数，未启用返回 -ENOTSUP
+int sck_mpu6050_bus_pm_stats(const struct device *dev, uint32_t *resumes, uint32_t *suspends);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef SCK_MPU6050_SCALE_H
+#define SCK_MPU6050_SCALE_H
+
+// sck_mpu6050 驱动的量程换算常量。不依赖Zephyr，纯C模块（orient_filter）
+// 和驱动共用，量程改动只改这里。
+
+// 陀螺仪：±1000°/s，32.8计数/(°/s)
+#define SCK_MPU6050_GYRO_COUNTS_PER_DPS_X10 328
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef INPUT_BUS_H
+#define INPUT_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "button_input.h"
+#include "tap_detector.h"
+
+// 敲击/按钮输入事件总线（zbus通道 input_chan）。
+// 检测线程和按钮工作队列只负责发布，LED/马达的响应在 src/input_response.c 的监听者里，
+// 监听者在发布者线程中同步执行，直接引用通道里的消息，不再拷贝。
+//
+// 每个事件带着触发它的样本时间（敲击为传感器样本时间戳，按钮为中断里记录的边沿时间），
+// 监听者改动输出前 input_latency_arm 取得一个令牌，随图层/马达请求交给 led_control、
+// motor_driver；带该令牌的那一帧/一步写完PWM后由它们上报 input_latency_applied 闭合测量，
+// 其他效果（心跳、呼吸）的写入不会误闭合。分三段记录延迟直方图：
+// 样本->检测发布、发布->PWM变化、样本->PWM变化。
+
+typedef enum {
+    INPUT_SRC_TAP = 0,
+    INPUT_SRC_BUTTON,
+    INPUT_SRC_NUM
+} input_src_t;
+
+typedef struct {
+    uint8_t src;                // input_src_t
+    uint8_t type;               // 敲击: gesture_t；按钮: button_evt_type_t
+    uint8_t index;              // 按钮序号，敲击为0
+    uint8_t count;              // 敲击次数 / 连击次数
+    uint32_t duration_ms;       // 按钮 RELEASE/LONG_PRESS 的按住时长
+    int64_t sample_ms;          // 触发事件的样本/边沿时间（k_uptime基准，FIFO模式每批读完时对齐）
+    int64_t publish_us;         // 发布时间，由 input_bus_publish 填写
+} input_event_t;
+
+// 发布一个事件，监听者在当前线程执行完才返回
+int input_bus_publish(input_event_t *evt);
+// 检测器确认手势后调用，evt为 det->st.gc.last
+int input_bus_publish_gesture(const GestureEvent *evt);
+// 与 button_event_cb_t 签名一致，可直接传给 button_input_init
+void input_bus_publish_button(const button_event_t *evt);
+
+// ===== 端到端延迟 =====
+typedef enum {
+    INPUT_LAT_DETECT = 0,       // 样本 -> 事件发布（含检测窗口、多击等待、消抖）
+    INPUT_LAT_OUTPUT,           // 事件发布 -> PWM变化（输出工作队列调度）
+    INPUT_LAT_TOTAL,            // 样本 -> PWM变化
+    INPUT_LAT_NUM
+} input_lat_seg_t;
+
+#define INPUT_LAT_BUCKET_MS     5       // 第i桶: [5i, 5i+5) ms，最后一桶含更大值
+#define INPUT_LAT_BUCKETS       20
+
+typedef struct {
+    uint32_t count;
+    uint32_t over_target;       // 超过 CONFIG_APP_INPUT_LATENCY_TARGET_MS 的次数
+    uint32_t negative;          // 终点早于起点（时钟不一致）的次数，不计入 count/直方图
+    uint32_t no_change;         // 响应没有改变输出（如已是同一颜色）的次数，不计入本段
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t hist[INPUT_LAT_BUCKETS];
+} input_lat_stats_t;
+
+#ifdef CONFIG_APP_INPUT_BUS
+
+// 监听者在改动LED/马达之前调用，登记待测事件（新事件覆盖尚未输出的旧事件）。
+// outputs为携带令牌的输出数（LED图层、马达请求），返回的令牌非0
+uint32_t input_latency_arm(const input_event_t *evt, int outputs);
+// 带令牌的帧/步骤写完后由 led_control、motor_driver 调用；changed为false表示
+// 这次响应没有改变输出。任一输出改变即闭合测量，全部未改变则计入 no_change
+void input_latency_applied(uint32_t token, bool changed);
+int input_latency_get(input_src_t src, input_lat_seg_t seg, input_lat_stats_t *out);
+void input_latency_reset(void);
+// 直方图上估算的百分位（桶上沿，ms），没有样本返回0
+uint32_t input_latency_percentile(const input_lat_stats_t *s, int pct);
+// 以机器可读格式输出全部延迟统计（printk）
+void input_latency_dump(void);
+
+// 注册响应用的马达模式，需在 motor_driver_init 之后调用
+int input_response_init(void);
+
+#else
+
+static inline void input_latency_applied(uint32_t token, bool changed)
+{
+    (void)token;
+    (void)changed;
+}
+
+#endif /* CONFIG_APP_INPUT_BUS */
+
+#endif
@@ -18,13 +18,40 @@ typedef enum {
 // 初始化LED硬件
 int led_control_init(void);
 
-// 设置混色（占空比百分比），可灵活调用
+#define LED_DUTY_MAX 65535U
+#define LED_PERCENT_TO_DUTY(pct) ((uint16_t)(((uint32_t)(pct) * LED_DUTY_MAX) / 100U))
+
+// 直接设置混色（占空比百分比），下一次合成帧会覆盖
 void led_control_set_color(uint8_t red_percent, uint8_t blue_percent);
 
-// 设置当前展示模式（预设的呼吸、危险等）
+// 设置混色（16位原始占空比，0~LED_DUTY_MAX），呼吸等渐变效果用这个避免低亮度台阶
+void led_control_set_duty(uint16_t red_duty, uint16_t blue_duty);
+
+// ===== 图层合成 =====
+// 多个来源各占一层，层号即优先级，高层盖在低层上面（alpha 255为不透明，0为空闲）。
+// 每帧只合成一次，结果与当前输出相同时不写PWM；被不透明层完全遮住的动态效果不再唤醒。
+// 合成结果红蓝都为0（如 LED_MODE_OFF）时 pwm_out 在空闲期后挂起LED的PWM控制器；
+// 动态效果按图层起始时间算相位，控制器唤醒的耗时不会累积成相位漂移。
+#define LED_LAYER_BASE      0       // 当前展示模式（led_control_set_mode）
+#define LED_LAYER_STATUS    1       // 持续状态指示，如低电量
+#define LED_LAYER_NOTIFY    2       // 短时提示，如双击确认闪烁
+#define LED_LAYER_NUM       3
+
+// 在layer层显示mode，duration_ms后自动移除并恢复下层（0为一直保持），可在中断里调用
+int led_control_push_layer(int layer, led_mode_t mode, uint8_t alpha, uint32_t duration_ms);
+// 同上，附带输入延迟令牌（input_latency_arm 返回值）：包含这一层的第一帧合成写完后
+// 上报 input_latency_applied，该层被遮住或合成结果不变时上报为未改变
+int led_control_push_layer_tagged(int layer, led_mode_t mode, uint8_t alpha,
+                                  uint32_t duration_ms, uint32_t tag);
+int led_control_clear_layer(int layer);
+
+// 设置当前展示模式（预设的呼吸、危险等），即基础层
 int led_control_set_mode(led_mode_t mode);
 
-// 必须周期调用，一般main里刷新（可放定时器任务/线程里）
+// 合成帧数和实际写PWM的次数，用于评估冗余写入
+void led_control_get_stats(uint32_t *frames, uint32_t *writes);
+
+// 动态效果由输出调度器按帧定时驱动，无需再周期调用；调用时立即合成一帧
 int led_control_periodic(void);
 
 #endif
\ No newline at end of file
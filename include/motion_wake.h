@@ -0,0 +1,66 @@
+#ifndef MOTION_WAKE_H
+#define MOTION_WAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tap_detector.h"
+
+// 静止休眠 / 运动唤醒：纯C实现，不依赖Zephyr，固件和主机回放共用。
+//
+// 活动状态下逐样本判断是否静止，连续静止 enter_ms 后进入低功耗：MPU6050
+// 切到低功耗周期模式只做运动检测，采样线程和I2C总线挂起。芯片运动中断唤醒后
+// 恢复全速采样，唤醒本身记为双击的第一次敲击（见 tap_detector_wake）。
+// 同时累计活动/休眠时间和唤醒次数，估算平均电流。
+
+// ===== 默认参数 =====
+#define MW_STILL_TH_DEFAULT     ((int32_t)(0.05f * ACCEL_SCALE))  // 各轴相对静止参考的最大偏差
+#define MW_ENTER_MS_DEFAULT     10000   // 连续静止多久进入休眠
+#define MW_WAKE_TH_MG_DEFAULT   100     // 运动唤醒阈值（MOT_THR，2mg/LSB）
+#define MW_LP_HZ_DEFAULT        40      // 低功耗周期模式唤醒频率：1(1.25)/5/20/40
+#define MW_RESUME_MS            15      // 唤醒到恢复全速采样的时间（总线恢复+重配）
+
+// ===== 电流估算参数(uA) =====
+// 传感器取MPU6050数据手册典型值，MCU为nRF54L15的粗略估计，按实测修改
+#define MW_UA_SENSOR_ACTIVE     3800    // 加速度+陀螺仪正常模式
+#define MW_UA_MCU_ACTIVE        60      // 50Hz采样、FIFO批量唤醒时的平均值
+#define MW_UA_MCU_IDLE          3       // System ON 空闲，I2C挂起
+
+typedef struct {
+    int32_t still_th;           // 计数
+    int32_t enter_ms;
+    int32_t wake_th;            // 计数，主机仿真运动检测用
+    int lp_hz;
+} MotionWakeCfg;
+
+typedef struct {
+    MotionWakeCfg cfg;
+    bool idle;
+    int16_t ref[3];             // 静止参考姿态（休眠时为上一次周期采样）
+    int64_t still_since;
+    int64_t state_since;        // 当前状态（活动/休眠）开始时间
+    int64_t last_lp_ts;
+    int64_t active_ms, idle_ms;
+    uint32_t wakeups;
+} MotionWake;
+
+typedef struct {
+    uint32_t wakeups;
+    uint32_t wakeups_per_hour;
+    uint32_t idle_permille;
+    uint32_t avg_ua;            // 估算平均电流
+    uint32_t always_on_ua;      // 不休眠时的电流，用于对比
+} MotionWakeReport;
+
+void motion_wake_default_cfg(MotionWakeCfg *cfg);
+void motion_wake_init(MotionWake *mw, const MotionWakeCfg *cfg, int64_t now);
+// 活动状态下每个样本调用一次，返回true表示已连续静止足够久、应进入休眠
+bool motion_wake_feed(MotionWake *mw, const AccelSample *s);
+void motion_wake_enter(MotionWake *mw, const AccelSample *last, int64_t now);
+void motion_wake_exit(MotionWake *mw, int64_t now);
+// 主机仿真：休眠时按 lp_hz 抽样模拟芯片运动检测，返回true表示触发唤醒
+bool motion_wake_sim_motion(MotionWake *mw, const AccelSample *s);
+void motion_wake_report(const MotionWake *mw, int64_t now, MotionWakeReport *r);
+// MPU6050 低功耗周期模式电流(uA)
+uint32_t motion_wake_lp_ua(int lp_hz);
+
+#endif
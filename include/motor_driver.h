@@ -1,6 +1,8 @@
 #ifndef MOTOR_DRIVER_H
 #define MOTOR_DRIVER_H
 
+#include <stdbool.h>
+#include <stdint.h>
 
 typedef enum {
     MOTOR_VIB_OFF = 0,
@@ -10,8 +12,35 @@ typedef enum {
     MOTOR_VIB_MODE_NUM
 } motor_vib_mode_t;
 
+// 振动步骤：duty_start != duty_end 时在 duration_ms 内线性渐变
+typedef struct {
+	uint8_t duty_start;     // 占空比 0~100%
+	uint8_t duty_end;
+	uint16_t duration_ms;
+} motor_step_t;
+
+#define MOTOR_REPEAT_FOREVER 0
+
+typedef struct {
+	const motor_step_t *steps;
+	uint8_t num_steps;
+	uint8_t repeat;         // 播放次数，MOTOR_REPEAT_FOREVER为循环
+} motor_pattern_t;
+
+#define MOTOR_PATTERN_MAX   8   // 含内置模式
+#define MOTOR_QUEUE_LEN     4   // 排队等待的模式数
+
 int motor_driver_init(void);
-int motor_driver_set_mode(motor_vib_mode_t mode); // 选择振动模式
-int motor_driver_periodic(void); // 可用于周期性处理
+int motor_driver_set_mode(motor_vib_mode_t mode); // 选择振动模式，立即打断当前模式
+int motor_driver_periodic(void); // 振动由输出调度器定时驱动，无需再周期调用，保留兼容
+
+// 运行时注册新模式，返回模式id（可传给 motor_driver_play），满了返回-ENOMEM
+int motor_driver_register_pattern(const motor_pattern_t *pattern);
+// 播放模式：preempt为true时立即打断当前模式并清空队列，否则排队在当前模式结束后播放
+// 可在中断上下文调用
+int motor_driver_play(int id, bool preempt);
+// 抢占播放并附带输入延迟令牌（input_latency_arm 返回值）：新模式第一步写完后上报
+// input_latency_applied，第一步占空比与当前相同时上报为未改变
+int motor_driver_play_tagged(int id, uint32_t tag);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,37 @@
+#ifndef ORIENT_FILTER_H
+#define ORIENT_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tap_detector.h"
+#include "drivers/sck_mpu6050_scale.h"
+
+// 整数互补滤波：陀螺仪积分预测重力方向，加速度模长接近1g时按固定比例拉回。
+// 纯C实现，不依赖Zephyr，全程整数运算。输出机体坐标系下的重力方向和角速度模长，
+// 交给 tap_detector_set_attitude 做旋转伪敲击抑制（偏航角不可观测，也不需要）。
+
+#define ORIENT_ACC_SHIFT    5               // 参考周期下的加速度校正比例 1/32，约0.6s时间常数
+#define ORIENT_ACC_REF_MS   SAMPLING_INTERVAL_MS    // 校正比例按 dt/参考周期 缩放，时间常数不随采样率变
+#define ORIENT_ACC_GATE     0.2f            // 加速度模长偏离1g超过此值（g）时只用陀螺仪
+#define ORIENT_DT_MAX_MS    100             // 采样间隔上限，断流后不做大角度积分
+
+// 加速度 + 陀螺仪原始计数（14字节burst中的两部分，温度不用）
+typedef struct {
+    AccelSample acc;
+    int16_t gx, gy, gz;
+} ImuSample;
+
+typedef struct {
+    int32_t g[3];                // 重力方向单位向量，1.0 = 2^22
+    int32_t rate_dps;            // 最近一个样本的角速度模长(°/s)
+    int64_t last_ts;
+    bool init;
+} OrientFilter;
+
+void orient_filter_init(OrientFilter *f);
+// 送入一个样本；第一个样本直接用加速度方向初始化
+void orient_filter_update(OrientFilter *f, const ImuSample *s);
+// 重力方向，模长 = ACCEL_SCALE 计数
+void orient_filter_gravity(const OrientFilter *f, int16_t out[3]);
+
+#endif
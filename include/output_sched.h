@@ -0,0 +1,18 @@
+#ifndef OUTPUT_SCHED_H
+#define OUTPUT_SCHED_H
+
+#include <zephyr/kernel.h>
+
+// LED/马达输出共用的调度器：一个专用工作队列，每个效果是一个延时工作项，
+// 只在效果的下一个时间点或模式切换时被唤醒，空闲时不占CPU。
+
+// 启动输出工作队列，必须在 led_control_init / motor_driver_init 之前调用
+int output_sched_init(void);
+
+// 未挂起时按delay调度；已挂起则保持原时间点
+int output_sched_schedule(struct k_work_delayable *dwork, k_timeout_t delay);
+
+// 无论是否已挂起都改成delay后执行，模式切换用 K_NO_WAIT 立即生效（可在中断里调用）
+int output_sched_reschedule(struct k_work_delayable *dwork, k_timeout_t delay);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef PWM_OUT_H
+#define PWM_OUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 设备树枚举的PWM输出通道（compatible "sck,pwm-outputs"）。
+// 每个通道属于一个角色，同一角色的所有通道输出相同占空比，
+// 多灯/多马达的产品变体只需改设备树。
+//
+// 写占空比分两步：pwm_out_stage 只暂存，pwm_out_commit 按控制器分组逐通道写入。
+// 暂存的变化在锁内取走，锁外连续写入（写入由互斥锁串行化，写入期间锁调度器，
+// 只有中断能插进来）。同一控制器的通道尽量在同一个PWM周期变化，但不保证：
+// Zephyr PWM API 每次只写一个通道，两次写入之间的中断可能让它们跨过周期边界；
+// pwm_nrfx 的0%/100%占空比用GPIO输出，立即生效，不等周期起点。
+// 红蓝渐变偶尔会错开一个PWM周期。
+//
+// 开启 CONFIG_PM_DEVICE_RUNTIME 时按控制器做运行时电源管理：控制器上所有通道
+// 归零并保持 APP_PWM_PM_IDLE_MS（至少一个PWM周期，保证0占空比已装载）后挂起，
+// 引脚切到设备树的sleep状态；有通道要输出时 commit 先唤醒控制器，再重写它的全部通道。
+
+// 顺序与 dts/bindings/led/sck,pwm-outputs.yaml 中 role 的枚举一致
+typedef enum {
+    PWM_OUT_RED = 0,
+    PWM_OUT_BLUE,
+    PWM_OUT_MOTOR,
+    PWM_OUT_ROLE_NUM
+} pwm_out_role_t;
+
+#define PWM_OUT_DUTY_MAX 65535U
+#define PWM_OUT_MAX_CHANNELS 32     // 脏标记位图宽度
+
+// 检查全部通道的控制器并打印通道表，全部输出0。
+// 必须在 led_control_init / motor_driver_init 之前调用
+int pwm_out_init(void);
+
+// 暂存某一角色所有通道的占空比（0~PWM_OUT_DUTY_MAX），值未变化的通道不标脏
+void pwm_out_stage(pwm_out_role_t role, uint16_t duty);
+
+// 写入所有已暂存的变化（通道间同步是尽力而为，见上），返回写入的通道数，
+// PWM写失败返回负错误码。
+// 同一次更新的几个角色应在同一线程里 stage 完再 commit（LED和马达都在输出工作队列上）。
+// 可能要唤醒控制器，不能在中断里调用
+int pwm_out_commit(void);
+
+// 最近一次 pwm_out_commit 唤醒控制器花费的时间(us)，没有唤醒为0。
+// 在同一线程里紧接着 commit 读取，效果据此补偿时序
+uint32_t pwm_out_last_resume_us(void);
+
+struct pwm_out_pm_stats {
+    uint32_t suspends;
+    uint32_t resumes;
+    uint32_t last_resume_us;
+    uint32_t max_resume_us;
+    uint32_t errors;            // runtime get/put 失败次数
+    bool suspended;
+};
+
+// 驱动某一角色的控制器的挂起/唤醒统计。没有该角色返回 -ENODEV，
+// 未开启运行时PM或控制器驱动不支持返回 -ENOTSUP
+int pwm_out_get_pm_stats(pwm_out_role_t role, struct pwm_out_pm_stats *out);
+
+// 某一角色的通道数，0表示该变体没有这种输出
+int pwm_out_role_channels(pwm_out_role_t role);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef RATE_GOVERNOR_H
+#define RATE_GOVERNOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tap_detector.h"
+
+// 自适应采样率：纯C实现，不依赖Zephyr，固件和主机回放共用。
+//
+// 检测器空闲（姿态稳定、没有进行中的敲击或连击序列，见 tap_detector_idle）
+// 持续 hold_ms 后降到低速档；低速档下相邻样本任一轴变化超过 wake_th 立即升到
+// 高速档，检测器不空闲时保持高速。检测器按样本时间戳工作，切换采样率不需要
+// 清空检测状态。低速档下短促的敲击可能不满足敲击起始条件，升速的那次突变
+// 由调用者用 tap_detector_wake 补记为连击序列的第一次敲击（与运动唤醒相同）。
+// 同时累计各档位的时间和样本数，给出平均采样率。
+
+// ===== 默认参数 =====
+#define RG_LOW_HZ_DEFAULT       25
+#define RG_HIGH_HZ_DEFAULT      100
+#define RG_HOLD_MS_DEFAULT      1000    // 空闲多久后降速，长于连击间隔上限
+#define RG_WAKE_MG_DEFAULT      150     // 低速档下升速的单样本变化阈值
+
+typedef struct {
+    int low_hz;
+    int high_hz;
+    int32_t hold_ms;
+    int32_t wake_th;            // 计数
+} RateGovernorCfg;
+
+typedef struct {
+    RateGovernorCfg cfg;
+    int hz;                     // 当前生效的采样率
+    bool have_prev;
+    int16_t prev[3];            // 上一个样本，低速档下算单样本变化
+    int64_t busy_ts;            // 最近一次检测器不空闲或出现突变的时间
+    int64_t state_since;        // 当前档位开始时间
+    int64_t low_ms, high_ms;
+    uint32_t samples;
+    uint32_t ramps;             // 低速 -> 高速的次数
+} RateGovernor;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t ramps;
+    uint32_t avg_hz_x10;        // 按各档位时间加权的平均采样率
+    uint32_t high_permille;     // 高速档时间占比
+} RateGovernorReport;
+
+void rate_governor_default_cfg(RateGovernorCfg *cfg);
+// 从高速档开始：上电时检测器还没有校准，也还不空闲
+void rate_governor_init(RateGovernor *rg, const RateGovernorCfg *cfg, int64_t now);
+// 每个样本调用一次，idle为检测器当前是否空闲。返回需要切换到的采样率，0表示不变；
+// 调用者切换成功后调用 rate_governor_commit，失败时不调用，下一个样本会再次请求
+int rate_governor_feed(RateGovernor *rg, const AccelSample *s, bool idle);
+void rate_governor_commit(RateGovernor *rg, int hz, int64_t now);
+void rate_governor_report(const RateGovernor *rg, int64_t now, RateGovernorReport *r);
+
+#endif
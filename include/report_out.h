@@ -0,0 +1,18 @@
+#ifndef REPORT_OUT_H
+#define REPORT_OUT_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+// 诊断报告（栈高水位、分段耗时、输入延迟）共用的输出：
+// sh为NULL时输出到printk（启动/状态日志），否则输出到shell命令
+#define REPORT_OUT(sh, fmt, ...)                                \
+    do {                                                        \
+        if (sh) {                                               \
+            shell_print(sh, fmt, ##__VA_ARGS__);                \
+        } else {                                                \
+            printk(fmt "\n", ##__VA_ARGS__);                    \
+        }                                                       \
+    } while (0)
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+// 无锁单生产者/单消费者环形队列
+// 生产者只写head，消费者只写tail，两端都可以在中断里调用（但各自只能有一个）。
+// 满时丢弃新元素并计入overruns，high_water记录出现过的最大占用。
+
+struct spsc_ring {
+    atomic_t head;          // 下一个写入序号（只由生产者修改）
+    atomic_t tail;          // 下一个读取序号（只由消费者修改）
+    atomic_t overruns;      // 因满丢弃的元素数
+    atomic_t high_water;    // 最大占用（生产者更新）
+    uint32_t mask;
+    uint32_t elem_size;
+    uint8_t *buf;
+};
+
+// size必须是2的幂
+#define SPSC_RING_DEFINE(name, type, size)                                  \
+    BUILD_ASSERT(IS_POWER_OF_TWO(size), "SPSC ring size must be power of 2"); \
+    static type name##_storage[size];                                       \
+    static struct spsc_ring name = {                                        \
+        .mask = (size) - 1,                                                 \
+        .elem_size = sizeof(type),                                          \
+        .buf = (uint8_t *)name##_storage,                                   \
+    }
+
+static inline uint32_t spsc_ring_used(const struct spsc_ring *r)
+{
+    return (uint32_t)atomic_get(&r->head) - (uint32_t)atomic_get(&r->tail);
+}
+
+static inline bool spsc_ring_put(struct spsc_ring *r, const void *elem)
+{
+    uint32_t head = (uint32_t)atomic_get(&r->head);
+    uint32_t used = head - (uint32_t)atomic_get(&r->tail);
+
+    if (used > r->mask) {
+        atomic_inc(&r->overruns);
+        return false;
+    }
+    memcpy(&r->buf[(head & r->mask) * r->elem_size], elem, r->elem_size);
+    // atomic_set带内存屏障，保证消费者看到head前数据已写入
+    atomic_set(&r->head, (atomic_val_t)(head + 1));
+
+    if (used + 1 > (uint32_t)atomic_get(&r->high_water)) {
+        atomic_set(&r->high_water, (atomic_val_t)(used + 1));
+    }
+    return true;
+}
+
+static inline bool spsc_ring_get(struct spsc_ring *r, void *elem)
+{
+    uint32_t tail = (uint32_t)atomic_get(&r->tail);
+
+    if ((uint32_t)atomic_get(&r->head) == tail) {
+        return false;
+    }
+    memcpy(elem, &r->buf[(tail & r->mask) * r->elem_size], r->elem_size);
+    atomic_set(&r->tail, (atomic_val_t)(tail + 1));
+    return true;
+}
+
+#endif
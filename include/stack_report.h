@@ -0,0 +1,20 @@
+#ifndef STACK_REPORT_H
+#define STACK_REPORT_H
+
+// 线程栈高水位报告：遍历所有线程，输出栈大小和实际用过的最大字节数。
+// 依赖 CONFIG_INIT_STACKS（栈初始化为0xAA，扫描未被改写的部分），由 CONFIG_APP_STACK_REPORT 选中。
+// 输出格式（每线程一行），供 scripts/stack_budget.py 生成 stack_sizes.conf：
+//   stack,<name>,<size>,<used>
+
+#ifdef CONFIG_APP_STACK_REPORT
+
+// 以机器可读格式输出全部线程的栈使用（printk）
+void stack_report_dump(void);
+
+#else
+
+static inline void stack_report_dump(void) {}
+
+#endif /* CONFIG_APP_STACK_REPORT */
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef STAGE_PROBE_H
+#define STAGE_PROBE_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+// 热路径分段耗时探针：基于 k_cycle_get_32()，每段统计 min/max/mean 和 log2 直方图。
+// 关闭 CONFIG_APP_STAGE_PROBES 时宏展开为空，不占代码和RAM。
+//
+//   STAGE_PROBE_BEGIN(t0);
+//   ... 被测代码 ...
+//   STAGE_PROBE_END(STAGE_DETECT, t0);
+
+typedef enum {
+    STAGE_I2C_READ = 0,     // 一次加速度读取（FIFO模式为一次完整排空）
+    STAGE_DETECT,           // 检测器处理一个样本
+    STAGE_LED_RENDER,       // LED效果渲染一帧
+    STAGE_MOTOR_STEP,       // 马达序列推进一步
+    STAGE_NUM
+} stage_id_t;
+
+#define STAGE_HIST_BUCKETS  16      // 第i桶: [2^i, 2^(i+1)) 个周期，最后一桶含更大值
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[STAGE_HIST_BUCKETS];
+} stage_stats_t;
+
+#ifdef CONFIG_APP_STAGE_PROBES
+
+#define STAGE_PROBE_BEGIN(var)      uint32_t var = k_cycle_get_32()
+#define STAGE_PROBE_END(stage, var) stage_probe_record((stage), k_cycle_get_32() - (var))
+
+void stage_probe_record(stage_id_t stage, uint32_t cycles);
+// 取一段统计的快照，stage越界返回-EINVAL
+int stage_probe_get(stage_id_t stage, stage_stats_t *out);
+void stage_probe_reset(void);
+const char *stage_probe_name(stage_id_t stage);
+// 以机器可读格式输出全部分段统计和线程CPU占用（printk）
+void stage_probe_dump(void);
+
+#else
+
+#define STAGE_PROBE_BEGIN(var)      do { } while (0)
+#define STAGE_PROBE_END(stage, var) do { } while (0)
+
+static inline void stage_probe_dump(void) {}
+
+#endif /* CONFIG_APP_STAGE_PROBES */
+
+#endif
@@ -0,0 +1,301 @@
+#ifndef TAP_DETECTOR_H
+#define TAP_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "tap_log.h"
+
+// 戒指双击检测器：纯C实现，不依赖Zephyr。
+// 时间由样本时间戳提供，日志通过 tap_detector_set_log 注入，
+// 因此同一份代码既能跑在板子上，也能在主机上回放数据。
+//
+// 阈值和窗口大小按参考采样周期 SAMPLING_INTERVAL_MS 标定，实际采样率可以不同且可在
+// 运行中改变（见 rate_governor.h）：冷却按时间戳计，平滑窗口按时间跨度淘汰，
+// 静止窗口和自校准按参考周期抽样，突变量按样本间隔归一化到参考周期。
+
+#define ACCEL_SCALE          16384.0f  // ±2g量程，1g对应的计数
+#define SAMPLING_INTERVAL_MS 20        // 阈值和窗口标定时的参考采样周期
+
+#define STATIC_WIN_DEFAULT  6       // 静止判定窗口（参考周期下的样本数），平衡响应速度和稳定性
+#define STATIC_WIN_MAX      256     // 窗口存储上限，运行时大小不超过此值
+#define SMOOTH_WIN_DEFAULT  3       // 平滑窗口大小（参考周期下的样本数）
+#define SMOOTH_WIN_MAX      16      // 平滑窗口存储，采样率高于参考时窗口内样本更多
+
+typedef struct {
+    int16_t ax, ay, az;
+    int64_t ts;                  // 采样时间戳(ms)
+} AccelSample;
+
+// ===== 手势 =====
+// 检测器每样本只算一次特征（平滑模长、姿态稳定、敲击确认），再由表驱动的
+// 分类器判定所有手势：连击按次数查表，晃动和静止各有一组共享计数，
+// 每样本开销与启用的手势数量无关。新增手势：在枚举里加一项，在
+// tap_detector.c 的 gesture_kind_tab 里登记种类，再给出默认参数。
+typedef enum {
+    GESTURE_NONE = 0,
+    GESTURE_SINGLE_TAP,
+    GESTURE_DOUBLE_TAP,
+    GESTURE_TRIPLE_TAP,
+    GESTURE_SHAKE,               // 短时间内多次大幅偏离1g
+    GESTURE_HOLD_STILL,          // 姿态持续稳定，每段静止只报一次
+    GESTURE_NUM
+} gesture_t;
+
+#define GESTURE_TAPS_MAX    3       // 连击手势的最大次数
+#define GESTURE_QUEUE_LEN   4       // 同一样本产生多个事件时顺延到后续样本返回
+
+// 每种手势一组参数，未用到的字段忽略
+typedef struct {
+    bool enabled;
+    uint16_t gap_min_ms;         // 连击：相邻两次敲击的间隔范围
+    uint16_t gap_max_ms;
+    uint16_t consist_x10;        // 连击：首次与本次敲击幅度比上限 x10，0为不检查
+    uint16_t cooldown_ms;        // 同一手势两次事件的最小间隔
+    uint16_t th_mg;              // 晃动：模长偏离重力参考的阈值
+    uint16_t count;              // 晃动：窗口内越过阈值的次数
+    uint16_t window_ms;          // 晃动：计数窗口；静止：需持续的时间
+} GestureParams;
+
+typedef struct {
+    gesture_t type;
+    uint8_t taps;                // 连击手势的敲击次数
+    int64_t ts;                  // 连击取最后一次敲击的时间，其余为判定时刻
+} GestureEvent;
+
+typedef struct {
+    GestureParams params[GESTURE_NUM];
+    // 加载参数时预先展开的连击序列规则，下标为序列中第几次敲击
+    uint8_t max_taps;
+    uint8_t tap_gesture[GESTURE_TAPS_MAX + 1];  // 敲击次数 -> gesture_t
+    uint16_t seq_gap_min[GESTURE_TAPS_MAX + 1];
+    uint16_t seq_gap_max[GESTURE_TAPS_MAX + 1];
+    uint16_t seq_consist[GESTURE_TAPS_MAX + 1];
+    // 连击序列
+    uint8_t taps;                // 已确认的敲击数，0表示没有进行中的序列
+    int64_t first_tap_ts;
+    int64_t last_tap_ts;
+    int32_t first_tap_mg;        // 0表示运动唤醒补记的敲击，不检查一致性
+    // 晃动/静止
+    bool shake_above;
+    uint16_t shake_count;
+    int64_t shake_start_ts;
+    int64_t still_since;         // <0 表示当前不静止
+    bool still_reported;
+    int64_t last_evt_ts[GESTURE_NUM];
+    // 事件队列
+    GestureEvent queue[GESTURE_QUEUE_LEN];
+    uint8_t q_head, q_len;
+    GestureEvent last;           // 最近一次由 process 返回的事件
+} GestureClassifier;
+
+// 日志回调，NULL表示不输出
+typedef void (*tap_log_cb_t)(const char *fmt, ...);
+
+// ===== 可调阈值 =====
+// 敲击前端的阈值（单位g/ms），默认值见 tap_params.h，tools/tap_tune 扫描的就是这些字段。
+// 连击间隔和一致性在 GestureParams 里
+typedef struct {
+    float spike_th;              // 平滑模长单样本上升超过此值开始一次敲击
+    float peak_abs_th;           // 且平滑模长超过此值
+    int min_duration_ms;         // 冲击最短持续时间
+    int cooldown_ms;             // 一次敲击后的冷却
+    float static_var_th;         // 静止判定：窗口方差(g^2)
+    float static_diff_th;        // 静止判定：窗口极差
+    float gravity_tol;           // 平滑模长偏离重力参考的容忍度
+    float posture_stable_th;     // 静止判定：窗口均值偏离重力参考
+    float axis_dom_min;          // 方向性：主轴最小强度
+    float axis_dom_ratio;        // 方向性：主轴与其余两轴之和的比
+} TapParams;
+
+// 定点检测器用的计数阈值：默认值 tap_params_q_default 由 tap_params.h 编译期换算，
+// 运行时参数用 tap_params_to_q 换算
+typedef struct {
+    int32_t spike, release, peak_abs;
+    int64_t static_var;
+    int32_t static_diff, gravity_tol, posture_stable;
+    int32_t axis_dom_min;
+    int64_t axis_dom_ratio_q16;
+    int min_duration_ms;
+    int cooldown_ms;
+} TapParamsQ;
+
+// ===== 单调队列（滑动窗口最值）=====
+typedef struct {
+    uint16_t *pos;
+    int cap, first, cnt;
+} MonoDeque;
+
+// ===== 增量统计窗口（浮点）=====
+typedef struct {
+    float *buff;
+    int size;
+    int head, len;
+    float sum, sum_sq;
+    MonoDeque minq, maxq;
+} FwStaticWin;
+
+// 按时间跨度 size*SAMPLING_INTERVAL_MS 滑动，存储固定为 SMOOTH_WIN_MAX
+typedef struct {
+    float *buff;
+    int64_t *ts;                 // 每个值的样本时间
+    int size;
+    int head, len;
+    float sum;
+} SmoothWin;
+
+typedef struct {
+    float gravity_ref;
+    int sample_count;
+    float sum;
+    bool calibrated;
+} CalibrationState;
+
+// 姿态输入（tap_detector_set_attitude），两种检测器共用，全部为整数
+typedef struct {
+    bool valid;                  // 从未设置时不做旋转抑制（纯加速度数据回放）
+    int16_t grav[3];             // 当前重力方向，模长 ACCEL_SCALE
+    int32_t rate_dps;            // 当前角速度模长(°/s)
+    int16_t start_grav[3];       // 敲击开始时的重力方向
+    int32_t peak_rate;           // 敲击期间的最大角速度
+} TapAttitude;
+
+typedef struct {
+    int64_t cd_until;            // 敲击冷却结束时间
+    int64_t tap_start_ts;
+    bool tap_in_progress;
+    SmoothWin smooth_win;        // 平滑窗口
+    float last_smooth_acc;       // 上一次的平滑值
+    int64_t last_ts;             // last_smooth_acc 的样本时间，用于归一化突变量
+    TapAttitude att;
+    GestureClassifier gc;
+} DoubleTapState;
+
+// ===== 定点版本（原始计数，1g = ACCEL_SCALE）=====
+typedef struct {
+    int32_t *buff;
+    int size;
+    int head, len;
+    int32_t sum;
+    int64_t sum_sq;
+    MonoDeque minq, maxq;
+} FwStaticWinQ;
+
+typedef struct {
+    int32_t *buff;
+    int64_t *ts;
+    int size;
+    int head, len;
+    int32_t sum;
+} SmoothWinQ;
+
+typedef struct {
+    int32_t gravity_ref;
+    int sample_count;
+    int32_t sum;
+    bool calibrated;
+} CalibrationStateQ;
+
+typedef struct {
+    int64_t cd_until;
+    int64_t tap_start_ts;
+    bool tap_in_progress;
+    SmoothWinQ smooth_win;
+    int32_t last_smooth_acc;
+    int64_t last_ts;
+    TapAttitude att;
+    GestureClassifier gc;
+} DoubleTapStateQ;
+
+// ===== 检测器实例（含窗口存储）=====
+typedef struct {
+    TapParams p;
+    FwStaticWin static_win;
+    DoubleTapState st;
+    CalibrationState cal;
+    float last_acc;              // 最近一个样本的模长(g)
+    bool win_started;
+    int64_t win_ts;              // 静止窗口最近一次抽样的时间
+    float static_buf[STATIC_WIN_MAX];
+    float smooth_buf[SMOOTH_WIN_MAX];
+    int64_t smooth_ts[SMOOTH_WIN_MAX];
+    uint16_t static_minq[STATIC_WIN_MAX];
+    uint16_t static_maxq[STATIC_WIN_MAX];
+} TapDetector;
+
+typedef struct {
+    TapParamsQ p;
+    FwStaticWinQ static_win;
+    DoubleTapStateQ st;
+    CalibrationStateQ cal;
+    int32_t last_acc;            // 最近一个样本的模长(计数)
+    bool win_started;
+    int64_t win_ts;
+    int32_t static_buf[STATIC_WIN_MAX];
+    int32_t smooth_buf[SMOOTH_WIN_MAX];
+    int64_t smooth_ts[SMOOTH_WIN_MAX];
+    uint16_t static_minq[STATIC_WIN_MAX];
+    uint16_t static_maxq[STATIC_WIN_MAX];
+} TapDetectorQ;
+
+// 设置全局文本日志输出（板上传printk，主机回放可传printf包装或NULL）。
+// 定义了 TAP_LOG_BINARY（CONFIG_APP_TAP_LOG_BINARY）时格式串不编译进来，此接口无效。
+void tap_detector_set_log(tap_log_cb_t cb);
+// 设置二进制日志记录输出（见 tap_log.h），与文本输出可同时使用
+void tap_detector_set_log_sink(tap_log_rec_cb_t cb);
+
+// 默认手势参数：单击/双击/三击/晃动/静止全部启用。
+// 启用三击时双击要等间隔超时才能确认（最多 gap_max_ms），只要双击时
+// 关掉单击和三击即可在第二次敲击时立即上报
+extern const GestureParams gesture_default_params[GESTURE_NUM];
+extern const TapParams tap_params_default;
+extern const TapParamsQ tap_params_q_default;
+
+// 浮点检测器：清零状态、设置窗口大小并加载默认阈值和手势参数，参数越界返回-EINVAL
+int tap_detector_init(TapDetector *det, int static_n, int smooth_n);
+// 运行时改窗口大小，清空窗口内容（检测状态保留）
+int tap_detector_set_windows(TapDetector *det, int static_n, int smooth_n);
+// 运行时替换手势参数表（GESTURE_NUM项，按 gesture_t 下标），清空进行中的序列。
+// 间隔范围、晃动计数等不合法时返回-EINVAL，原参数保留
+int tap_detector_set_gestures(TapDetector *det, const GestureParams params[GESTURE_NUM]);
+// 运行时替换敲击阈值（检测状态保留）
+void tap_detector_set_params(TapDetector *det, const TapParams *p);
+// 处理一个样本，返回本样本确认的手势，详情（敲击次数、时间）见 det->st.gc.last
+gesture_t tap_detector_process(TapDetector *det, const AccelSample *s);
+float tap_detector_gravity_ref(const TapDetector *det);
+// 姿态稳定且没有进行中的敲击或连击序列，采样率调节据此降到低速
+bool tap_detector_idle(const TapDetector *det);
+// 运动唤醒：低功耗期间被芯片运动中断"吃掉"的第一次敲击，在ts时刻补记为
+// 连击序列的第一次敲击（幅度未知，第二次敲击不做一致性检查）
+void tap_detector_wake(TapDetector *det, int64_t ts);
+// 姿态输入：orient_filter 给出的重力方向（模长 ACCEL_SCALE）和角速度模长(°/s)，
+// 每个样本在 process 之前调用。敲击期间角速度过大或前后姿态变化过大时判为
+// 手腕转动引起的伪敲击，不计入连击
+void tap_detector_set_attitude(TapDetector *det, const int16_t grav[3], int32_t rate_dps);
+
+// 定点检测器：全程整数运算，接口同上，模长单位为计数
+int tap_detector_q_init(TapDetectorQ *det, int static_n, int smooth_n);
+int tap_detector_q_set_windows(TapDetectorQ *det, int static_n, int smooth_n);
+int tap_detector_q_set_gestures(TapDetectorQ *det, const GestureParams params[GESTURE_NUM]);
+// 阈值以计数给出（tap_params_q_default 或 tap_params_to_q 的结果）
+void tap_detector_q_set_params(TapDetectorQ *det, const TapParamsQ *p);
+// 浮点阈值换算成计数（主机工具、运行时调参用）
+void tap_params_to_q(const TapParams *p, TapParamsQ *out);
+gesture_t tap_detector_q_process(TapDetectorQ *det, const AccelSample *s);
+int32_t tap_detector_q_gravity_ref(const TapDetectorQ *det);
+bool tap_detector_q_idle(const TapDetectorQ *det);
+void tap_detector_q_wake(TapDetectorQ *det, int64_t ts);
+void tap_detector_q_set_attitude(TapDetectorQ *det, const int16_t grav[3], int32_t rate_dps);
+// 批量处理（如FIFO一次排空的样本）：prepare 对n个样本算模长（accel_block.h 的批量
+// 内核）并推进平滑窗口，结果写入 mag/smooth；之后按顺序对每个样本调用
+// process_prepared，结果与逐个调用 tap_detector_q_process 相同。stride为相邻样本的
+// 字节距离，样本可以嵌在更大的结构里。中间可以设置姿态或唤醒，但不能改窗口大小
+void tap_detector_q_prepare(TapDetectorQ *det, const AccelSample *s, size_t stride, int n,
+                            int32_t *mag, int32_t *smooth);
+gesture_t tap_detector_q_process_prepared(TapDetectorQ *det, const AccelSample *s,
+                                          int32_t mag, int32_t smooth);
+
+// 计数转毫g，用于日志
+#define ACCEL_COUNTS_TO_MG(q) ((int)(((int64_t)(q) * 1000) / (int32_t)ACCEL_SCALE))
+
+#endif
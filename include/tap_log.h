@@ -0,0 +1,106 @@
+#ifndef TAP_LOG_H
+#define TAP_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 检测器日志字典：固件和主机解码器共用的唯一一份格式串表。
+//
+// 二进制模式下固件只记录 {消息ID, 样本时间戳, 原始参数}，格式串不进镜像，
+// 由后台以十六进制行 "#TL:" 输出，主机端 tools/tap_log_decode 按本表还原文本。
+// 参数统一为32位：%d 为int32，%f 为float的原始位。新增消息只能追加在表尾，
+// 否则旧日志的ID会错位。
+
+#define TAP_LOG_LVL_NONE    0
+#define TAP_LOG_LVL_INF     1       // 校准结果、双击确认
+#define TAP_LOG_LVL_DBG     2       // 单次敲击的中间状态
+
+#define TAP_LOG_MAX_ARGS    3
+#define TAP_LOG_LINE_PREFIX "#TL:"
+
+// X(名称, 级别, 格式串)
+#define TAP_LOG_DICT(X)                                                                   \
+    X(CAL_DONE,       INF, "Gravity calibrated to %.3f\n")                                \
+    X(CAL_REJECT,     INF, "Calibration rejected: %.3f too far from nominal\n")           \
+    X(TAP_START,      DBG, "Tap start detected (smooth_acc: %.2f, spike: %.2f)\n")        \
+    X(TAP_END,        DBG, "Tap end detected (duration: %dms)\n")                         \
+    X(FIRST_TAP,      DBG, "First tap confirmed (mag: %.2f)\n")                           \
+    X(DOUBLE_TAP,     INF, "Double tap confirmed! (dt: %dms, mag1: %.2f, mag2: %.2f)\n")  \
+    X(DT_COOLDOWN,    DBG, "Double tap in cooldown period\n")                             \
+    X(INCONSISTENT,   DBG, "Inconsistent tap magnitudes: %.2f vs %.2f (ratio: %.2f)\n")   \
+    X(DT_RANGE,       DBG, "Double tap timing out of range: %dms\n")                      \
+    X(RESET_FIRST,    DBG, "Reset to new first tap\n")                                    \
+    X(TAP_TIMEOUT,    DBG, "Tap timeout after %dms\n")                                    \
+    X(DT_TIMEOUT,     DBG, "Double tap timeout, reset\n")                                 \
+    X(CAL_DONE_Q,     INF, "Gravity calibrated to %d mg\n")                               \
+    X(CAL_REJECT_Q,   INF, "Calibration rejected: %d mg too far from nominal\n")          \
+    X(TAP_START_Q,    DBG, "Tap start detected (smooth_acc: %d mg, spike: %d mg)\n")      \
+    X(FIRST_TAP_Q,    DBG, "First tap confirmed (mag: %d mg)\n")                          \
+    X(DOUBLE_TAP_Q,   INF, "Double tap confirmed! (dt: %dms, mag1: %d mg, mag2: %d mg)\n") \
+    X(INCONSISTENT_Q, DBG, "Inconsistent tap magnitudes: %d vs %d mg\n")              \
+    X(WAKE_FIRST,     DBG, "Motion wake taken as first tap\n")                           \
+    X(ROT_REJECT,     DBG, "Tap rejected as rotation (peak: %d dps, tilt cos: %d/1000)\n") \
+    X(GESTURE,        INF, "Gesture %d confirmed (taps: %d, span: %dms)\n")                \
+    X(GESTURE_CD,     DBG, "Gesture %d in cooldown period\n")                             \
+    X(TAP_N_Q,        DBG, "Tap %d in sequence (dt: %dms, mag: %d mg)\n")
+
+#define TAP_LOG_X_ID(name, lvl, fmt)  TAP_LOG_ID_##name,
+#define TAP_LOG_X_LVL(name, lvl, fmt) TAP_LOG_LEVEL_OF_##name = TAP_LOG_LVL_##lvl,
+
+enum { TAP_LOG_DICT(TAP_LOG_X_ID) TAP_LOG_ID_COUNT };
+enum { TAP_LOG_DICT(TAP_LOG_X_LVL) };
+
+// 一条日志记录；输出时只编码前 8 + 4*nargs 字节（小端）
+typedef struct {
+    uint16_t id;
+    uint8_t nargs;
+    uint8_t reserved;
+    uint32_t ts;                        // 样本时间戳(ms)低32位
+    uint32_t args[TAP_LOG_MAX_ARGS];
+} TapLogRecord;
+
+// 一行编码的最大长度：前缀 + 十六进制 + '\0'
+#define TAP_LOG_LINE_MAX    (sizeof(TAP_LOG_LINE_PREFIX) + (8 + 4 * TAP_LOG_MAX_ARGS) * 2)
+
+// 编码为 "#TL:" + 小端字节的十六进制（不含换行），返回字符数
+static inline int tap_log_encode_line(const TapLogRecord *rec, char *buf)
+{
+    static const char hex[] = "0123456789abcdef";
+    uint8_t raw[8 + 4 * TAP_LOG_MAX_ARGS];
+    int nargs = rec->nargs > TAP_LOG_MAX_ARGS ? TAP_LOG_MAX_ARGS : rec->nargs;
+    int len = 8 + 4 * nargs;
+    int pos = 0;
+
+    raw[0] = (uint8_t)rec->id;
+    raw[1] = (uint8_t)(rec->id >> 8);
+    raw[2] = (uint8_t)nargs;
+    raw[3] = 0;
+    for (int i = 0; i < 4; i++) {
+        raw[4 + i] = (uint8_t)(rec->ts >> (8 * i));
+    }
+    for (int a = 0; a < nargs; a++) {
+        for (int i = 0; i < 4; i++) {
+            raw[8 + 4 * a + i] = (uint8_t)(rec->args[a] >> (8 * i));
+        }
+    }
+
+    for (const char *p = TAP_LOG_LINE_PREFIX; *p; p++) {
+        buf[pos++] = *p;
+    }
+    for (int i = 0; i < len; i++) {
+        buf[pos++] = hex[raw[i] >> 4];
+        buf[pos++] = hex[raw[i] & 0x0F];
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+// 记录输出回调，由检测器所在线程同步调用，实现方应只做入队
+typedef void (*tap_log_rec_cb_t)(const TapLogRecord *rec);
+
+// 固件后端（src/tap_log_uart.c）：记录进无锁队列，由系统工作队列批量输出为 "#TL:" 行。
+// 队列满时丢弃，丢弃数由 tap_log_uart_dropped() 返回。
+void tap_log_uart_put(const TapLogRecord *rec);
+uint32_t tap_log_uart_dropped(void);
+
+#endif
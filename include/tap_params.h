@@ -0,0 +1,26 @@
+#ifndef TAP_PARAMS_H
+#define TAP_PARAMS_H
+
+// 敲击检测器的可调阈值（默认值，单位g或ms）。
+// tools/tap_tune 在标注数据上扫描参数后会生成同样格式的文件，直接替换本文件即可构建。
+
+// ===== 戒指优化的双击参数 =====
+#define TAP_SPIKE_TH        0.30f   // 突变阈值（稍微放宽）
+#define TAP_PEAK_ABS_TH     1.20f   // 绝对值阈值（稍微放宽）
+#define TAP_MIN_DURATION_MS 25      // 最小冲击持续时间
+#define TAP_COOLDOWN_MS     180     // 单次tap冷却
+#define DOUBLE_TAP_MIN_MS   100     // 连击最小间隔
+#define DOUBLE_TAP_MAX_MS   500     // 连击最大间隔
+
+// ===== 戒指专用静止判定参数 =====
+#define STATIC_VAR_TH       0.040f  // 放宽方差阈值（考虑手指微动）
+#define STATIC_DIFF_TH      0.15f   // 放宽差值阈值
+#define GRAVITY_TOLERANCE   0.18f   // 放宽重力偏差容忍度
+#define POSTURE_STABLE_TH   0.25f   // 放宽姿态稳定阈值
+
+// ===== 方向性检测参数 =====
+#define AXIS_DOMINANCE_MIN   0.8f   // 主轴最小强度
+#define AXIS_DOMINANCE_RATIO 1.4f   // 主轴优势比例（降低要求）
+#define TAP_CONSISTENCY_X10  25     // 连击一致性比例 2.5（略放宽）
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef TRACE_CODEC_H
+#define TRACE_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tap_detector.h"
+
+// 加速度样本的块压缩格式：纯C实现，不依赖Zephyr，固件记录器（src/trace_rec.c）
+// 和主机提取工具（tools/trace_extract）共用。
+//
+// 每块最多 TRACE_BLOCK_SIZE 字节，可以单独解码，小端：
+//   uint32_t seq                块序号，记录器内全局递增
+//   uint32_t ts0                首样本时间戳(ms，低32位)
+//   int16_t  ax, ay, az         首样本原始计数
+//   uint16_t count              样本数（含首样本）
+//   uint16_t len                块总字节数（含头）
+//   之后每个样本：varint(与上一样本的间隔ms) + 三轴与上一样本之差的 zigzag varint
+// 静止时一个样本通常4~5字节（原始8字节）。每次追加都更新头里的count/len，
+// 块在任何时刻都是完整可解码的。
+
+#define TRACE_BLOCK_SIZE        256
+#define TRACE_BLOCK_HDR_SIZE    18
+#define TRACE_SAMPLE_MAX_BYTES  14      // varint(uint32) + 3 * varint(zigzag int17)
+
+// 编码状态，块数据本身在调用者提供的缓冲区里
+typedef struct {
+    uint8_t *blk;
+    uint16_t len;
+    uint16_t count;
+    uint32_t prev_ts;
+    int16_t prev[3];
+} TraceBlockEnc;
+
+// 以s为首样本开始一个新块
+void trace_block_start(TraceBlockEnc *enc, uint8_t *blk, uint32_t seq, const AccelSample *s);
+// 追加一个样本，块内放不下时返回false（样本未写入，调用者开新块）
+bool trace_block_append(TraceBlockEnc *enc, const AccelSample *s);
+
+// 解码一块，返回样本数（不超过max），格式错误返回-EINVAL
+int trace_block_decode(const uint8_t *blk, size_t size, uint32_t *seq,
+                       AccelSample *out, int max);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef TRACE_REC_H
+#define TRACE_REC_H
+
+#include <stdint.h>
+#include "tap_detector.h"
+#include "trace_codec.h"
+
+// 现场数据记录器：RAM里按块压缩（trace_codec.h）保存最近一段原始加速度，
+// 手势确认或shell命令 "trace save" 时把触发点前 PRE_MS、后 POST_MS 的块写入
+// storage_partition 上的FCB（只追加，满了擦最旧的扇区）。已写入的块不会重复写，
+// 触发前后重叠的窗口共用同一批块；写入后当前块立即封口，之后的样本进新块。
+//
+// flash条目（首字节为类型）：
+//   TRACE_ENTRY_BLOCK    'B' + 压缩块
+//   TRACE_ENTRY_TRIGGER  'T' + uint8 reason(gesture_t，GESTURE_NONE为手动) + 2字节填充
+//                        + uint32 触发时间(ms) + uint32 首块seq + uint32 末块seq
+// "trace dump" 以 "#TR:" 十六进制行输出全部条目，tools/trace_extract 还原为 .sckt。
+//
+// trace_rec_put 在检测线程里执行，不碰flash：提交时只把块范围交给低优先级的写入线程，
+// 由它追加FCB和擦扇区。写入落后到块被新样本覆盖时放弃该窗口并计入errors。
+// trigger 可在任意线程调用。
+
+#define TRACE_LINE_PREFIX       "#TR:"
+#define TRACE_ENTRY_BLOCK       'B'
+#define TRACE_ENTRY_TRIGGER     'T'
+#define TRACE_TRIGGER_SIZE      16
+
+typedef struct {
+    uint32_t samples;           // 记录的样本数
+    uint32_t enc_bytes;         // 压缩后字节数（含块头）
+    uint32_t commits;           // 写入flash的窗口数
+    uint32_t skipped;           // 因间隔限制、正在等待或写入队列满而忽略的触发
+    uint32_t flash_bytes;       // 累计写入flash的字节数
+    uint32_t errors;
+    uint32_t ram_span_ms;       // RAM中保存的时间跨度
+} TraceRecStats;
+
+// 挂载FCB，失败时记录器只在RAM里工作，不写flash
+int trace_rec_init(void);
+void trace_rec_put(const AccelSample *s);
+// 请求提交触发点ts附近的窗口，reason为确认的手势，GESTURE_NONE为手动请求（立即提交）
+void trace_rec_trigger(gesture_t reason, int64_t ts);
+void trace_rec_get_stats(TraceRecStats *out);
+
+#endif
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""按模块统计固件ROM/RAM占用，并与 footprint_budget.txt 中的预算比较。
+
+从链接map里把每个输入段归到它的目标文件（tap_detector.c.obj -> tap_detector.c）
+和所在的库（libkernel.a）。段属于ROM还是RAM由ELF中输出段的标志决定：
+不可写的段只占ROM，可写的PROGBITS段（.data）两者都占，NOBITS段（.bss/.noinit）只占RAM。
+ELF符号表同时用于检查禁止进入镜像的符号（最小配置下的libm和浮点格式化）。
+
+任何条目超出预算或出现禁止符号时返回1，构建目标随之失败。
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+# 输入段行：" .text.foo  0xADDR  0xSIZE  path/lib.a(obj.c.obj)"，名字过长时地址另起一行
+SECTION_RE = re.compile(r"^ (\S+)\s*$")
+ENTRY_RE = re.compile(r"^ (?:(\S+)\s+)?0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+OUTPUT_RE = re.compile(r"^(\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+MEMBER_RE = re.compile(r"^(.*?)\((.*)\)$")
+
+
+def parse_size(text):
+    text = text.strip().upper()
+    scale = 1
+    if text.endswith("K"):
+        scale, text = 1024, text[:-1]
+    return int(text, 0) * scale
+
+
+def output_sections(elf):
+    """输出段名 -> (占ROM, 占RAM)"""
+    kinds = {}
+    for sec in elf.iter_sections():
+        flags = sec["sh_flags"]
+        if not flags & SH_FLAGS.SHF_ALLOC or sec["sh_size"] == 0:
+            continue
+        writable = bool(flags & SH_FLAGS.SHF_WRITE)
+        nobits = sec["sh_type"] == "SHT_NOBITS"
+        kinds[sec.name] = (not nobits, writable)
+    return kinds
+
+
+def module_names(path):
+    """目标文件路径 -> (模块名, 库名)"""
+    m = MEMBER_RE.match(path)
+    if m:
+        lib, obj = os.path.basename(m.group(1)), m.group(2)
+    else:
+        lib, obj = "(objects)", os.path.basename(path)
+    if obj.endswith(".obj"):
+        obj = obj[:-4]
+    elif obj.endswith(".o"):
+        obj = obj[:-2]
+    return obj, lib
+
+
+def parse_map(path, kinds):
+    """返回 {模块: [rom, ram]}, {库: [rom, ram]}"""
+    modules, libs = {}, {}
+    in_map = False
+    out_kind = None
+    pending = None
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+            if line and not line[0].isspace():
+                m = OUTPUT_RE.match(line)
+                out_kind = kinds.get(m.group(1)) if m else None
+                pending = None
+                continue
+            if out_kind is None:
+                continue
+            m = SECTION_RE.match(line)
+            if m and not line.startswith(" *"):
+                pending = m.group(1)
+                continue
+            m = ENTRY_RE.match(line)
+            if not m or (m.group(1) is None and pending is None):
+                pending = None
+                continue
+            name = m.group(1) or pending
+            pending = None
+            size = int(m.group(3), 16)
+            if size == 0 or name.startswith("*"):
+                continue
+            obj, lib = module_names(m.group(4).strip())
+            in_rom, in_ram = out_kind
+            for table, key in ((modules, obj), (libs, lib)):
+                acc = table.setdefault(key, [0, 0])
+                acc[0] += size if in_rom else 0
+                acc[1] += size if in_ram else 0
+    return modules, libs
+
+
+def image_totals(elf):
+    rom = ram = 0
+    for sec in elf.iter_sections():
+        flags = sec["sh_flags"]
+        if not flags & SH_FLAGS.SHF_ALLOC:
+            continue
+        nobits = sec["sh_type"] == "SHT_NOBITS"
+        if not nobits:
+            rom += sec["sh_size"]
+        if flags & SH_FLAGS.SHF_WRITE:
+            ram += sec["sh_size"]
+    return rom, ram
+
+
+def image_symbols(elf):
+    names = set()
+    for sec in elf.iter_sections():
+        if isinstance(sec, SymbolTableSection):
+            names.update(sym.name for sym in sec.iter_symbols() if sym.name)
+    return names
+
+
+def load_budget(path, profiles):
+    """预算文件：'<模块> <rom> <ram>'，'forbid <符号>...'，'[profile]' 之后的行只在该配置下生效"""
+    budget, forbid = {}, set()
+    active = True
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            if line.startswith("[") and line.endswith("]"):
+                active = line[1:-1] in profiles
+                continue
+            if not active:
+                continue
+            fields = line.split()
+            if fields[0] == "forbid":
+                forbid.update(fields[1:])
+            elif len(fields) == 3:
+                budget[fields[0]] = (parse_size(fields[1]), parse_size(fields[2]))
+            else:
+                sys.exit(f"{path}:{lineno}: expected '<module> <rom> <ram>'")
+    return budget, forbid
+
+
+def read_profiles(config_path):
+    profiles = {"default"}
+    if config_path and os.path.exists(config_path):
+        with open(config_path, encoding="utf-8") as f:
+            if any(l.strip() == "CONFIG_APP_MINIMAL=y" for l in f):
+                profiles.add("minimal")
+    return profiles
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--map", required=True)
+    parser.add_argument("--budget", required=True)
+    parser.add_argument("--config", help="构建目录的 .config，用于选择预算配置")
+    parser.add_argument("--top", type=int, default=15, help="列出占用最大的N个模块")
+    args = parser.parse_args()
+
+    profiles = read_profiles(args.config)
+    budget, forbid = load_budget(args.budget, profiles)
+
+    with open(args.elf, "rb") as f:
+        elf = ELFFile(f)
+        kinds = output_sections(elf)
+        total = image_totals(elf)
+        symbols = image_symbols(elf)
+    modules, libs = parse_map(args.map, kinds)
+
+    print(f"profile: {'+'.join(sorted(profiles))}")
+    print(f"{'module':28s} {'rom':>8s} {'ram':>8s}")
+    ranked = sorted(modules.items(), key=lambda kv: -(kv[1][0] + kv[1][1]))
+    for name, (rom, ram) in ranked[:args.top]:
+        print(f"{name:28s} {rom:8d} {ram:8d}")
+    print(f"{'library':28s} {'rom':>8s} {'ram':>8s}")
+    for name, (rom, ram) in sorted(libs.items(), key=lambda kv: -(kv[1][0] + kv[1][1])):
+        print(f"{name:28s} {rom:8d} {ram:8d}")
+    print(f"{'total':28s} {total[0]:8d} {total[1]:8d}")
+
+    failed = False
+    print("budget:")
+    for name, (rom_max, ram_max) in sorted(budget.items()):
+        if name == "total":
+            rom, ram = total
+        else:
+            rom, ram = modules.get(name) or libs.get(name) or (0, 0)
+        over = rom > rom_max or ram > ram_max
+        failed |= over
+        print(f"  {'OVER' if over else 'ok':4s} {name:24s} rom {rom:7d}/{rom_max:<7d} "
+              f"ram {ram:7d}/{ram_max:<7d}")
+
+    found = sorted(forbid & symbols)
+    if found:
+        failed = True
+        print(f"  FORBIDDEN symbols in image: {' '.join(found)}")
+
+    if failed:
+        print("footprint budget exceeded", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
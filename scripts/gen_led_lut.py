@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""生成LED呼吸灯查找表（16位占空比，0~65535对应0~100%）。
+
+每一步一个条目，led_control_periodic 刷新时只需查表+两次PWM写入，
+不再在LED线程里调用 sin/powf。
+"""
+
+import argparse
+import math
+
+DUTY_MAX = 65535
+
+
+def breath_raw(i, steps, gamma):
+    # 与原 sine_breathe 一致：从灭灯开始的正弦，再做伽马校正
+    phase = 2.0 * math.pi * i / steps
+    raw = (math.sin(phase - math.pi / 2) + 1.0) / 2.0
+    return raw ** gamma
+
+
+def duty(x):
+    return max(0, min(DUTY_MAX, int(round(x * DUTY_MAX))))
+
+
+def emit_table(out, name, rows):
+    out.write(f"static const uint16_t {name}[LED_LUT_STEPS][2] = {{\n")
+    for red, blue in rows:
+        out.write(f"    {{ {red:5d}, {blue:5d} }},\n")
+    out.write("};\n\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--steps", type=int, required=True)
+    parser.add_argument("--gamma", type=float, default=2.0)
+    parser.add_argument("--user-min", type=float, default=0.2,
+                        help="LED_MODE_USER_BREATH 最小亮度")
+    parser.add_argument("--user-blue-ratio", type=float, default=0.3,
+                        help="LED_MODE_USER_BREATH 蓝色相对红色的比例")
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    breath = []
+    user = []
+    for i in range(args.steps):
+        raw = breath_raw(i, args.steps, args.gamma)
+        blue = duty(raw)
+        breath.append((DUTY_MAX - blue, blue))   # 红蓝反向
+        red = duty(args.user_min + (1.0 - args.user_min) * raw)
+        user.append((red, duty(red / DUTY_MAX * args.user_blue_ratio)))
+
+    with open(args.output, "w", encoding="utf-8") as out:
+        out.write("/* 由 scripts/gen_led_lut.py 生成，请勿手改 */\n")
+        out.write("#ifndef LED_LUT_H\n#define LED_LUT_H\n\n#include <stdint.h>\n\n")
+        out.write(f"#define LED_LUT_STEPS {args.steps}\n\n")
+        out.write("/* {red, blue}，16位占空比 */\n")
+        emit_table(out, "led_breath_lut", breath)
+        emit_table(out, "led_user_breath_lut", user)
+        out.write("#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""根据栈高水位报告生成线程栈大小配置片段（stack_sizes.conf）。
+
+输入为开启 CONFIG_APP_STACK_REPORT 后的控制台日志，其中的
+"stack,<name>,<size>,<used>" 行取每个线程的最大used，乘以余量后按对齐向上取整。
+只处理下表中有对应Kconfig符号的线程，其余线程（idle、shell等）只打印不输出。
+"""
+
+import argparse
+import re
+import sys
+
+# 线程名 -> 栈大小的Kconfig符号
+THREAD_SYMBOLS = {
+    "tap_detect": "CONFIG_APP_DETECT_STACK_SIZE",
+    "output_sched": "CONFIG_APP_OUTPUT_STACK_SIZE",
+    "sck_mpu6050": "CONFIG_SCK_MPU6050_WORKQ_STACK_SIZE",
+    "main": "CONFIG_MAIN_STACK_SIZE",
+    "sysworkq": "CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE",
+}
+
+LINE_RE = re.compile(r"stack,([^,]+),(\d+),(\d+)")
+
+
+def parse(lines):
+    usage = {}
+    for line in lines:
+        m = LINE_RE.search(line)
+        if not m:
+            continue
+        name, size, used = m.group(1), int(m.group(2)), int(m.group(3))
+        old = usage.get(name, (size, 0))
+        usage[name] = (size, max(old[1], used))
+    return usage
+
+
+def round_up(v, align):
+    return (v + align - 1) // align * align
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("logs", nargs="+", help="控制台日志，'-' 为标准输入")
+    parser.add_argument("-o", "--output", help="输出文件（默认标准输出）")
+    parser.add_argument("--margin", type=float, default=0.25,
+                        help="高水位之上的余量比例（默认0.25）")
+    parser.add_argument("--align", type=int, default=64)
+    parser.add_argument("--min", type=int, default=512, help="栈大小下限")
+    args = parser.parse_args()
+
+    lines = []
+    for path in args.logs:
+        f = sys.stdin if path == "-" else open(path, encoding="utf-8", errors="replace")
+        lines.extend(f)
+        if f is not sys.stdin:
+            f.close()
+
+    usage = parse(lines)
+    if not usage:
+        sys.exit("no 'stack,<name>,<size>,<used>' lines found, "
+                 "build with CONFIG_APP_STACK_REPORT=y")
+
+    out = [
+        "# 线程栈大小，由 scripts/stack_budget.py 根据栈高水位报告生成：",
+        "#   west build -- -DCONFIG_APP_STACK_REPORT=y 后跑典型负载，保存控制台日志",
+        "#   scripts/stack_budget.py console.log -o stack_sizes.conf",
+        f"# 余量 {args.margin:.0%}，{args.align}字节对齐，下限 {args.min}",
+    ]
+    for name, (size, used) in sorted(usage.items()):
+        new = max(args.min, round_up(int(used * (1.0 + args.margin)), args.align))
+        sym = THREAD_SYMBOLS.get(name)
+        print(f"{name:16s} size {size:6d} used {used:6d} -> {new:6d}"
+              f"{'' if sym else '  (no Kconfig symbol, skipped)'}", file=sys.stderr)
+        if sym:
+            out.append(f"# {name}: 高水位 {used} / {size}")
+            out.append(f"{sym}={new}")
+
+    text = "\n".join(out) + "\n"
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#include "accel_block.h"
+#include <string.h>
+
+#if ACCEL_BLOCK_SIMD
+#include <arm_acle.h>
+#endif
+
+#define SAMPLE_AT(xyz, stride, i) \
+    ((const int16_t *)((const uint8_t *)(xyz) + (size_t)(i) * (stride)))
+
+#define NEWTON_MAX_ITER     4       // 初值在结果的1/2~2倍内时4次迭代足够收敛到±1
+
+uint32_t accel_isqrt(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+uint32_t accel_isqrt_seeded(uint32_t v, uint32_t seed)
+{
+    uint32_t r = seed;
+
+    if (v == 0) return 0;
+    if (r == 0 || r > ACCEL_MAG_MAX || v < r * r / 4 || v / 4 > r * r) {
+        return accel_isqrt(v);
+    }
+    for (int i = 0; i < NEWTON_MAX_ITER; i++) {
+        uint32_t next = (r + v / r) >> 1;
+        if (next == r) break;
+        r = next;
+    }
+    // 整数牛顿迭代可能停在相邻值上来回跳，修正到向下取整
+    while (r * r > v) r--;
+    while ((r + 1) * (r + 1) <= v) r++;
+    return r;
+}
+
+// ===== 平方和 =====
+static inline uint32_t mag_sq_c(const int16_t *p)
+{
+    return (uint32_t)((int32_t)p[0] * p[0]) + (uint32_t)((int32_t)p[1] * p[1]) +
+           (uint32_t)((int32_t)p[2] * p[2]);
+}
+
+#if ACCEL_BLOCK_SIMD
+// ax,ay相邻，一次32位读出后SMUAD算 ax²+ay²，SMLABB再累加 az²。
+// 有符号累加在3*2^30时会溢出（置Q标志），但按uint32解释的结果仍然正确
+static inline uint32_t mag_sq_simd(const int16_t *p)
+{
+    int16x2_t xy;
+
+    memcpy(&xy, p, sizeof(xy));
+    return (uint32_t)__smlabb(p[2], p[2], __smuad(xy, xy));
+}
+#define mag_sq mag_sq_simd
+#else
+#define mag_sq mag_sq_c
+#endif
+
+void accel_block_mag_sq(const int16_t *xyz, size_t stride, int n, uint32_t *out)
+{
+    for (int i = 0; i < n; i++) {
+        out[i] = mag_sq(SAMPLE_AT(xyz, stride, i));
+    }
+}
+
+// ===== 模长 =====
+void accel_block_mag(const int16_t *xyz, size_t stride, int n, int32_t seed, int32_t *mag)
+{
+    uint32_t prev = seed > 0 ? (uint32_t)seed : 0;
+
+    for (int i = 0; i < n; i++) {
+        prev = accel_isqrt_seeded(mag_sq(SAMPLE_AT(xyz, stride, i)), prev);
+        mag[i] = (int32_t)prev;
+    }
+}
+
+void accel_block_mag_ref(const int16_t *xyz, size_t stride, int n, int32_t *mag)
+{
+    for (int i = 0; i < n; i++) {
+        mag[i] = (int32_t)accel_isqrt(mag_sq_c(SAMPLE_AT(xyz, stride, i)));
+    }
+}
@@ -1,4 +1,5 @@
 #include "button_input.h"
+#include "spsc_ring.h"
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 
@@ -7,6 +8,8 @@
 #define BUTTON_SW2_NODE DT_ALIAS(sw2)
 #define BUTTON_SW3_NODE DT_ALIAS(sw3)
 
+#define EDGE_RING_SIZE  32      // 2的幂，足够容纳抖动期内所有按钮的边沿
+
 static const struct gpio_dt_spec buttons[BUTTON_NUM] = {
     GPIO_DT_SPEC_GET(BUTTON_SW0_NODE, gpios),
     GPIO_DT_SPEC_GET(BUTTON_SW1_NODE, gpios),
@@ -17,17 +20,160 @@ static const struct gpio_dt_spec buttons[BUTTON_NUM] = {
 static struct gpio_callback btn_cb_data[BUTTON_NUM];
 static button_event_cb_t g_btn_cb = NULL;
 
-// 生产级支持所有SWx的callback
-static void button_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+// ===== 中断 -> 工作队列 的边沿队列 =====
+// 中断里只记录“哪个按钮、什么时刻有边沿”，电平判断、消抖、分类都放到线程上下文。
+// 所有按钮的GPIO中断优先级相同、不会互相抢占，因此满足单生产者条件。
+typedef struct {
+    int64_t ticks;
+    uint8_t index;
+} btn_edge_t;
+
+SPSC_RING_DEFINE(edge_ring, btn_edge_t, EDGE_RING_SIZE);
+
+// ===== 每个按钮的消抖/分类状态（只在工作队列中访问）=====
+typedef struct {
+    bool pressed;           // 消抖后的稳定状态
+    bool edge_pending;      // 有尚未确认的边沿
+    bool long_sent;         // 本次按住已上报长按
+    uint8_t clicks;         // 等待确认的连击数
+    int64_t first_edge;     // 本轮抖动的第一条边沿（作为事件时间）
+    int64_t last_edge;      // 本轮抖动的最后一条边沿
+    int64_t press_ts;
+    int64_t release_ts;
+} btn_state_t;
+
+static btn_state_t btn_state[BUTTON_NUM];
+
+static void btn_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(btn_work, btn_work_handler);
+
+static inline int64_t ticks_to_ms(int64_t ticks)
+{
+    return (int64_t)k_ticks_to_ms_floor64((uint64_t)ticks);
+}
+
+static void emit(button_index_t idx, button_evt_type_t type, int64_t ts,
+                 uint32_t duration_ms, uint8_t clicks)
 {
+    button_event_t evt = {
+        .index = idx,
+        .type = type,
+        .timestamp_ms = ticks_to_ms(ts),
+        .duration_ms = duration_ms,
+        .clicks = clicks,
+    };
+
+    if (g_btn_cb) {
+        g_btn_cb(&evt);
+    }
+}
+
+// 稳定电平确认后的状态迁移
+static void btn_transition(button_index_t idx, bool pressed)
+{
+    btn_state_t *b = &btn_state[idx];
+
+    if (pressed == b->pressed) {
+        return;     // 抖了一圈又回到原电平
+    }
+    b->pressed = pressed;
+
+    if (pressed) {
+        b->press_ts = b->first_edge;
+        b->long_sent = false;
+        emit(idx, BUTTON_EVT_PRESS, b->press_ts, 0, 0);
+        return;
+    }
+
+    b->release_ts = b->first_edge;
+    emit(idx, BUTTON_EVT_RELEASE, b->release_ts,
+         (uint32_t)ticks_to_ms(b->release_ts - b->press_ts), 0);
+
+    if (b->long_sent) {
+        b->clicks = 0;      // 长按后的松开不算单击
+        return;
+    }
+    if (++b->clicks >= 3) {
+        emit(idx, BUTTON_EVT_TRIPLE_CLICK, b->release_ts, 0, b->clicks);
+        b->clicks = 0;      // 三击已是上限，不必再等间隔超时
+    }
+}
+
+static void btn_work_handler(struct k_work *work)
+{
+    const int64_t debounce = k_ms_to_ticks_ceil64(BUTTON_DEBOUNCE_MS);
+    const int64_t long_press = k_ms_to_ticks_ceil64(BUTTON_LONG_PRESS_MS);
+    const int64_t multi_gap = k_ms_to_ticks_ceil64(BUTTON_MULTI_CLICK_MS);
+    int64_t now = k_uptime_ticks();
+    int64_t next = INT64_MAX;
+    btn_edge_t e;
+
+    ARG_UNUSED(work);
+
+    while (spsc_ring_get(&edge_ring, &e)) {
+        btn_state_t *b = &btn_state[e.index];
+        if (!b->edge_pending) {
+            b->first_edge = e.ticks;
+            b->edge_pending = true;
+        }
+        b->last_edge = e.ticks;
+    }
+
     for (int i = 0; i < BUTTON_NUM; ++i) {
-        if ((pins & BIT(buttons[i].pin)) && g_btn_cb) {
-            bool pressed = !gpio_pin_get_dt(&buttons[i]);     // Active low
-            g_btn_cb(i, pressed);
+        btn_state_t *b = &btn_state[i];
+
+        if (b->edge_pending) {
+            if (now - b->last_edge >= debounce) {
+                b->edge_pending = false;
+                btn_transition(i, !gpio_pin_get_dt(&buttons[i]));     // Active low
+            } else {
+                next = MIN(next, b->last_edge + debounce);
+            }
+        }
+
+        if (b->pressed && !b->long_sent) {
+            if (now - b->press_ts >= long_press) {
+                b->long_sent = true;
+                b->clicks = 0;
+                emit(i, BUTTON_EVT_LONG_PRESS, b->press_ts,
+                     (uint32_t)ticks_to_ms(now - b->press_ts), 0);
+            } else {
+                next = MIN(next, b->press_ts + long_press);
+            }
         }
+
+        if (!b->pressed && b->clicks > 0) {
+            if (now - b->release_ts >= multi_gap) {
+                emit(i, b->clicks == 1 ? BUTTON_EVT_CLICK : BUTTON_EVT_DOUBLE_CLICK,
+                     b->release_ts, 0, b->clicks);
+                b->clicks = 0;
+            } else {
+                next = MIN(next, b->release_ts + multi_gap);
+            }
+        }
+    }
+
+    if (next != INT64_MAX) {
+        k_work_reschedule(&btn_work, K_TICKS(MAX(next - now, 1)));
     }
 }
 
+// 生产级支持所有SWx的callback；中断里只打时间戳
+static void button_handler(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+    btn_edge_t e = {
+        .ticks = k_uptime_ticks(),
+        .index = (uint8_t)(cb - btn_cb_data),
+    };
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(pins);
+
+    spsc_ring_put(&edge_ring, &e);
+    // 每条边沿都把处理推迟到抖动结束后
+    k_work_reschedule(&btn_work, K_MSEC(BUTTON_DEBOUNCE_MS));
+}
+
 int button_input_init(button_event_cb_t cb)
 {
     g_btn_cb = cb;
@@ -36,10 +182,12 @@ int button_input_init(button_event_cb_t cb)
             printk("Button %d device not ready!\n", i);
         }
         gpio_pin_configure_dt(&buttons[i], GPIO_INPUT);
+        btn_state[i].pressed = !gpio_pin_get_dt(&buttons[i]);     // 以上电时电平为初始状态
         gpio_pin_interrupt_configure_dt(&buttons[i], GPIO_INT_EDGE_BOTH); // 按下松开都响应
 
+        // 每个按钮一个callback，按callback地址反查index，避免不同端口同号引脚串扰
         gpio_init_callback(&btn_cb_data[i], button_handler, BIT(buttons[i].pin));
         gpio_add_callback(buttons[i].port, &btn_cb_data[i]);
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,254 @@
+#include "input_bus.h"
+#include "report_out.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#define PUBLISH_TIMEOUT     K_MSEC(5)   // 只会和另一个发布者竞争通道锁
+#define LAT_TARGET_US       (CONFIG_APP_INPUT_LATENCY_TARGET_MS * 1000U)
+
+// 观察者由 input_response.c 用 ZBUS_CHAN_ADD_OBS 挂上
+ZBUS_CHAN_DEFINE(input_chan, input_event_t, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+static const char *const src_names[INPUT_SRC_NUM] = {
+    [INPUT_SRC_TAP]    = "tap",
+    [INPUT_SRC_BUTTON] = "button",
+};
+
+static const char *const seg_names[INPUT_LAT_NUM] = {
+    [INPUT_LAT_DETECT] = "detect",
+    [INPUT_LAT_OUTPUT] = "output",
+    [INPUT_LAT_TOTAL]  = "total",
+};
+
+static inline int64_t now_us(void)
+{
+    return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+// ===== 发布 =====
+int input_bus_publish(input_event_t *evt)
+{
+    evt->publish_us = now_us();
+    return zbus_chan_pub(&input_chan, evt, PUBLISH_TIMEOUT);
+}
+
+int input_bus_publish_gesture(const GestureEvent *evt)
+{
+    input_event_t e = {
+        .src = INPUT_SRC_TAP,
+        .type = evt->type,
+        .count = evt->taps,
+        .sample_ms = evt->ts,
+    };
+
+    return input_bus_publish(&e);
+}
+
+void input_bus_publish_button(const button_event_t *evt)
+{
+    input_event_t e = {
+        .src = INPUT_SRC_BUTTON,
+        .type = evt->type,
+        .index = evt->index,
+        .count = evt->clicks,
+        .duration_ms = evt->duration_ms,
+        .sample_ms = evt->timestamp_ms,
+    };
+
+    input_bus_publish(&e);
+}
+
+// ===== 延迟统计 =====
+static struct k_spinlock lat_lock;
+static input_lat_stats_t lat[INPUT_SRC_NUM][INPUT_LAT_NUM];
+static bool armed;
+static uint8_t armed_src;
+static uint8_t armed_left;          // 还没上报的输出数
+static uint32_t armed_token;
+static uint32_t next_token;
+static int64_t armed_sample_us;
+static int64_t armed_publish_us;
+
+static void lat_record(input_lat_stats_t *s, int64_t us)
+{
+    if (us < 0) {
+        s->negative++;
+        return;
+    }
+
+    uint32_t v = (uint32_t)MIN(us, (int64_t)UINT32_MAX);
+    uint32_t bucket = v / (INPUT_LAT_BUCKET_MS * 1000U);
+
+    s->count++;
+    s->sum_us += v;
+    s->max_us = MAX(s->max_us, v);
+    s->over_target += v > LAT_TARGET_US;
+    s->hist[MIN(bucket, INPUT_LAT_BUCKETS - 1)]++;
+}
+
+uint32_t input_latency_arm(const input_event_t *evt, int outputs)
+{
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+    if (++next_token == 0) {
+        next_token = 1;
+    }
+    armed = true;
+    armed_src = evt->src;
+    armed_left = (uint8_t)MAX(outputs, 1);
+    armed_token = next_token;
+    armed_sample_us = evt->sample_ms * 1000;
+    armed_publish_us = evt->publish_us;
+
+    uint32_t token = armed_token;
+    k_spin_unlock(&lat_lock, key);
+    return token;
+}
+
+// 在输出工作队列里调用，令牌不是当前登记的事件（已被新事件覆盖）时忽略
+void input_latency_applied(uint32_t token, bool changed)
+{
+    int64_t now = now_us();
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+    if (armed && token == armed_token) {
+        input_lat_stats_t *s = lat[armed_src];
+
+        if (changed) {
+            armed = false;
+            lat_record(&s[INPUT_LAT_DETECT], armed_publish_us - armed_sample_us);
+            lat_record(&s[INPUT_LAT_OUTPUT], now - armed_publish_us);
+            lat_record(&s[INPUT_LAT_TOTAL], now - armed_sample_us);
+        } else if (--armed_left == 0) {
+            // 检测段照常有效，输出段没有可测的PWM变化
+            armed = false;
+            lat_record(&s[INPUT_LAT_DETECT], armed_publish_us - armed_sample_us);
+            s[INPUT_LAT_OUTPUT].no_change++;
+            s[INPUT_LAT_TOTAL].no_change++;
+        }
+    }
+    k_spin_unlock(&lat_lock, key);
+}
+
+int input_latency_get(input_src_t src, input_lat_seg_t seg, input_lat_stats_t *out)
+{
+    if (src >= INPUT_SRC_NUM || seg >= INPUT_LAT_NUM) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+    *out = lat[src][seg];
+    k_spin_unlock(&lat_lock, key);
+    return 0;
+}
+
+void input_latency_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lat_lock);
+    memset(lat, 0, sizeof(lat));
+    armed = false;
+    k_spin_unlock(&lat_lock, key);
+}
+
+uint32_t input_latency_percentile(const input_lat_stats_t *s, int pct)
+{
+    uint32_t need = (uint32_t)(((uint64_t)s->count * pct + 99) / 100);
+    uint32_t acc = 0;
+
+    if (s->count == 0) {
+        return 0;
+    }
+    for (int b = 0; b < INPUT_LAT_BUCKETS - 1; b++) {
+        acc += s->hist[b];
+        if (acc >= need) {
+            return (b + 1) * INPUT_LAT_BUCKET_MS;
+        }
+    }
+    return DIV_ROUND_UP(s->max_us, 1000U);
+}
+
+// ===== 输出 =====
+// 机器可读格式，每行一条记录：
+//   latency,<src>,<seg>,<count>,<over_target>,<negative>,<no_change>,<mean_us>,<max_us>,<h0>..<h19>
+static void dump_csv(const struct shell *sh)
+{
+    REPORT_OUT(sh, "latency_cfg,%u,%u", INPUT_LAT_BUCKET_MS, CONFIG_APP_INPUT_LATENCY_TARGET_MS);
+    for (int src = 0; src < INPUT_SRC_NUM; src++) {
+        for (int seg = 0; seg < INPUT_LAT_NUM; seg++) {
+            input_lat_stats_t s;
+            char hist[INPUT_LAT_BUCKETS * 11 + 1];
+            int pos = 0;
+
+            input_latency_get(src, seg, &s);
+            for (int b = 0; b < INPUT_LAT_BUCKETS; b++) {
+                pos += snprintk(&hist[pos], sizeof(hist) - pos, ",%u", s.hist[b]);
+            }
+            REPORT_OUT(sh, "latency,%s,%s,%u,%u,%u,%u,%u,%u%s", src_names[src], seg_names[seg],
+                       s.count, s.over_target, s.negative, s.no_change,
+                       s.count ? (uint32_t)(s.sum_us / s.count) : 0, s.max_us, hist);
+        }
+    }
+}
+
+void input_latency_dump(void)
+{
+    dump_csv(NULL);
+}
+
+#ifdef CONFIG_SHELL
+static void show_table(const struct shell *sh)
+{
+    REPORT_OUT(sh, "  %-7s %-7s %6s %8s %8s %8s %8s %6s %6s %6s", "source", "segment", "count",
+               "mean(ms)", "p50(ms)", "p95(ms)", "max(ms)", "over", "neg", "same");
+    for (int src = 0; src < INPUT_SRC_NUM; src++) {
+        for (int seg = 0; seg < INPUT_LAT_NUM; seg++) {
+            input_lat_stats_t s;
+
+            input_latency_get(src, seg, &s);
+            REPORT_OUT(sh, "  %-7s %-7s %6u %8u %8u %8u %8u %6u %6u %6u",
+                       src_names[src], seg_names[seg], s.count,
+                       s.count ? (uint32_t)(s.sum_us / s.count / 1000) : 0,
+                       input_latency_percentile(&s, 50), input_latency_percentile(&s, 95),
+                       s.max_us / 1000, s.over_target, s.negative, s.no_change);
+        }
+    }
+    REPORT_OUT(sh, "  target %d ms, buckets of %d ms", CONFIG_APP_INPUT_LATENCY_TARGET_MS,
+               INPUT_LAT_BUCKET_MS);
+}
+
+// ===== shell命令: latency show | dump | reset =====
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    show_table(sh);
+    return 0;
+}
+
+static int cmd_latency_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    dump_csv(sh);
+    return 0;
+}
+
+static int cmd_latency_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    input_latency_reset();
+    shell_print(sh, "latency stats cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_latency,
+    SHELL_CMD(show, NULL, "Input-to-PWM latency per source and segment", cmd_latency_show),
+    SHELL_CMD(dump, NULL, "Machine-readable dump (CSV lines)", cmd_latency_dump),
+    SHELL_CMD(reset, NULL, "Clear latency statistics", cmd_latency_reset),
+    SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(latency, &sub_latency, "Tap/button to PWM latency", NULL);
+#endif
@@ -0,0 +1,123 @@
+#include "input_bus.h"
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include "led_control.h"
+#include "motor_driver.h"
+
+// 输入事件 -> LED/马达的响应策略。监听者在发布者线程里执行（检测线程或按钮所在的
+// 系统工作队列），这里只改图层和排马达模式，真正写PWM在输出工作队列上。
+
+#define ACK_FLASH_MS        500     // 多击确认闪烁时长
+#define ACK_BLINK_MS        150     // 单击提示时长
+#define SHAKE_NOTIFY_MS     300
+
+ZBUS_CHAN_DECLARE(input_chan);
+
+// 敲击确认：一次短振，不循环，结束后马达停在空闲
+static const motor_step_t ack_steps[] = {
+    { 90, 90, 40 },
+    {  0,  0, 60 },
+};
+static const motor_pattern_t ack_once = { ack_steps, ARRAY_SIZE(ack_steps), 1 };
+static const motor_pattern_t ack_twice = { ack_steps, ARRAY_SIZE(ack_steps), 2 };
+
+static int ack_once_id = -1;
+static int ack_twice_id = -1;
+
+// 延迟令牌随图层/马达请求交下去，只有这次响应自己的输出才闭合测量
+static void on_gesture(const input_event_t *evt)
+{
+    uint32_t tag;
+
+    switch (evt->type) {
+    case GESTURE_SINGLE_TAP:
+        tag = input_latency_arm(evt, 1);
+        led_control_push_layer_tagged(LED_LAYER_NOTIFY, LED_MODE_BLUE, 255, ACK_BLINK_MS, tag);
+        break;
+    case GESTURE_DOUBLE_TAP:
+        tag = input_latency_arm(evt, 2);
+        led_control_push_layer_tagged(LED_LAYER_NOTIFY, LED_MODE_FLASH, 255, ACK_FLASH_MS, tag);
+        motor_driver_play_tagged(ack_once_id, tag);
+        break;
+    case GESTURE_TRIPLE_TAP:
+        tag = input_latency_arm(evt, 2);
+        led_control_push_layer_tagged(LED_LAYER_NOTIFY, LED_MODE_FLASH, 255, ACK_FLASH_MS, tag);
+        motor_driver_play_tagged(ack_twice_id, tag);
+        break;
+    case GESTURE_SHAKE:
+        tag = input_latency_arm(evt, 1);
+        led_control_push_layer_tagged(LED_LAYER_NOTIFY, LED_MODE_PURPLE, 255, SHAKE_NOTIFY_MS,
+                                      tag);
+        break;
+    default:
+        break;      // 静止不需要反馈
+    }
+}
+
+static void on_button(const input_event_t *evt)
+{
+    static led_mode_t led_mode = LED_MODE_RED;
+    static int motor_pwm_mode = 0;
+
+    switch (evt->type) {
+    case BUTTON_EVT_PRESS:
+        break;
+    case BUTTON_EVT_LONG_PRESS:
+        printk("BUTTON_SW%d long press (%u ms)\n", evt->index, evt->duration_ms);
+        return;
+    case BUTTON_EVT_DOUBLE_CLICK:
+    case BUTTON_EVT_TRIPLE_CLICK:
+        printk("BUTTON_SW%d %d-click\n", evt->index, evt->count);
+        // 多击确认：提示层闪一下，结束后自动恢复当前模式
+        led_control_push_layer_tagged(LED_LAYER_NOTIFY, LED_MODE_FLASH, 255, ACK_FLASH_MS,
+                                      input_latency_arm(evt, 1));
+        return;
+    default:
+        return; // 松开和单击确认暂不处理
+    }
+
+    switch (evt->index) {
+    case BUTTON_SW0:
+        // 切换 LED1 不同 PWM 模式
+        led_mode = (led_mode + 1) % LED_MODE_NUM;
+        led_control_push_layer_tagged(LED_LAYER_BASE, led_mode, 255, 0,
+                                      input_latency_arm(evt, 1));
+        printk("LED模式切换到: %d\n", led_mode);
+        break;
+    case BUTTON_SW1:
+        motor_pwm_mode = (motor_pwm_mode + 1) % MOTOR_VIB_MODE_NUM;
+        motor_driver_play_tagged(motor_pwm_mode, input_latency_arm(evt, 1));
+        printk("马达PWM模式切换到: %d\n", motor_pwm_mode);
+        break;
+    case BUTTON_SW2:
+        printk("BUTTON_SW2 pressed\n");
+        break;
+    case BUTTON_SW3:
+        printk("BUTTON_SW3 pressed\n");
+        break;
+    default:
+        break;
+    }
+}
+
+// 直接引用通道里的消息，不拷贝；先登记延迟再改输出，令牌在输出之前就已生效
+static void input_response_cb(const struct zbus_channel *chan)
+{
+    const input_event_t *evt = zbus_chan_const_msg(chan);
+
+    if (evt->src == INPUT_SRC_TAP) {
+        on_gesture(evt);
+    } else {
+        on_button(evt);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(input_response_lis, input_response_cb);
+ZBUS_CHAN_ADD_OBS(input_chan, input_response_lis, 0);
+
+int input_response_init(void)
+{
+    ack_once_id = motor_driver_register_pattern(&ack_once);
+    ack_twice_id = motor_driver_register_pattern(&ack_twice);
+    return ack_once_id < 0 ? ack_once_id : (ack_twice_id < 0 ? ack_twice_id : 0);
+}
@@ -1,108 +1,242 @@
 #include "led_control.h"
-#include <zephyr/drivers/pwm.h>
+#include <errno.h>
 #include <zephyr/kernel.h>
-#include <math.h>        // for sin/pow
-
-#define M_PI 3.14159265358979323846
+#include "input_bus.h"
+#include "led_lut.h"     // 构建时由 scripts/gen_led_lut.py 生成
+#include "output_sched.h"
+#include "pwm_out.h"
+#include "stage_probe.h"
 
 // 呼吸灯参数
 #define BREATH_PERIOD_MS    2000
 #define BREATH_UPDATE_MS    10
 #define BREATH_STEPS        (BREATH_PERIOD_MS / BREATH_UPDATE_MS)
+#define FLASH_PERIOD_MS     250
+
+BUILD_ASSERT(LED_LUT_STEPS == BREATH_STEPS, "LED breath LUT size mismatch, check CMakeLists.txt");
+BUILD_ASSERT(LED_DUTY_MAX == PWM_OUT_DUTY_MAX, "LED duty scale must match pwm_out");
+
+// ===== 图层 =====
+typedef struct {
+    led_mode_t mode;
+    uint8_t alpha;              // 0表示该层空闲
+    int64_t start_ms;           // 动态效果的相位基准
+    int64_t expire_ms;          // 到期自动移除，0为不超时
+    uint32_t tag;               // 输入延迟令牌，第一帧合成后上报并清零
+} led_layer_t;
 
-static struct pwm_dt_spec led_red = PWM_DT_SPEC_GET(DT_ALIAS(ledred));
-static struct pwm_dt_spec led_blue = PWM_DT_SPEC_GET(DT_ALIAS(ledblue));
+static struct k_spinlock layer_lock;
+static led_layer_t layers[LED_LAYER_NUM];
 
-static uint8_t current_red = 0;
-static uint8_t current_blue = 0;
-static led_mode_t current_mode = LED_MODE_RED;
+// 当前硬件输出，合成结果不变时不写PWM
+static uint16_t current_red = 0;
+static uint16_t current_blue = 0;
+static uint32_t frame_count;
+static uint32_t write_count;
+
+static void led_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(led_work, led_work_handler);
 
 int led_control_init(void)
 {
-    if (device_is_ready(led_red.dev) && device_is_ready(led_blue.dev)) {
-        printk("LED Red PWM period: %u ns\n", led_red.period);
-        printk("LED Blue PWM period: %u ns\n", led_blue.period);
-    }
+    printk("LED channels: red %d, blue %d\n",
+           pwm_out_role_channels(PWM_OUT_RED), pwm_out_role_channels(PWM_OUT_BLUE));
     led_control_set_color(0, 0);
-    return 0;
+    return led_control_set_mode(LED_MODE_RED);
+}
+
+// 输出有变化时写PWM并返回true
+static bool led_write(uint16_t red_duty, uint16_t blue_duty)
+{
+    if (red_duty == current_red && blue_duty == current_blue) {
+        return false;
+    }
+    current_red = red_duty;
+    current_blue = blue_duty;
+    write_count++;
+    // 红蓝一起提交，同一控制器上的通道尽量在同一个PWM周期变化
+    pwm_out_stage(PWM_OUT_RED, red_duty);
+    pwm_out_stage(PWM_OUT_BLUE, blue_duty);
+    pwm_out_commit();
+    return true;
+}
+
+void led_control_set_duty(uint16_t red_duty, uint16_t blue_duty)
+{
+    led_write(red_duty, blue_duty);
 }
 
 void led_control_set_color(uint8_t red_percent, uint8_t blue_percent)
 {
     if (red_percent > 100) red_percent = 100;
     if (blue_percent > 100) blue_percent = 100;
-    current_red = red_percent;
-    current_blue = blue_percent;
-    pwm_set_dt(&led_red, led_red.period, (red_percent * led_red.period) / 100);
-    pwm_set_dt(&led_blue, led_blue.period, (blue_percent * led_blue.period) / 100);
+    led_control_set_duty(LED_PERCENT_TO_DUTY(red_percent), LED_PERCENT_TO_DUTY(blue_percent));
 }
 
-int led_control_set_mode(led_mode_t mode)
+int led_control_push_layer_tagged(int layer, led_mode_t mode, uint8_t alpha,
+                                  uint32_t duration_ms, uint32_t tag)
 {
-    current_mode = mode;
+    if (layer < 0 || layer >= LED_LAYER_NUM || mode >= LED_MODE_NUM) {
+        return -EINVAL;
+    }
+
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&layer_lock);
+
+    layers[layer] = (led_layer_t){
+        .mode = mode,
+        .alpha = alpha,
+        .start_ms = now,
+        .expire_ms = duration_ms ? now + duration_ms : 0,
+        .tag = tag,
+    };
+    k_spin_unlock(&layer_lock, key);
+
+    // 立即合成新的一帧
+    output_sched_reschedule(&led_work, K_NO_WAIT);
     return 0;
 }
 
-// 呼吸灯丝滑算法：正弦+伽马校正
-static uint8_t sine_breathe(float phase)
+int led_control_push_layer(int layer, led_mode_t mode, uint8_t alpha, uint32_t duration_ms)
 {
-    // phase: 0~2π, 输出0~100的“视觉均匀”亮度
-    float raw = (sin(phase - M_PI/2) + 1.0f) / 2.0f; // sine, M_PI/2初始灭灯，0~1
-    float gamma = 2.0f; // 亮度均匀视觉修正
-    raw = powf(raw, gamma); // gamma校正
-    uint8_t pct = (uint8_t)(raw * 100.0f);
-    return pct;
+    return led_control_push_layer_tagged(layer, mode, alpha, duration_ms, 0);
 }
 
-int led_control_periodic(void)
+int led_control_clear_layer(int layer)
 {
-    static int breath_cnt = 0;      // 呼吸步进
-    static int blink = 0;           // 闪烁计数
-    switch (current_mode) {
-    case LED_MODE_BREATH: {
-        breath_cnt = (breath_cnt + 1) % BREATH_STEPS;
-        float phase = ((float)breath_cnt / (float)BREATH_STEPS) * 2.0f * M_PI; // 0~2π
-        uint8_t blue = sine_breathe(phase);           // 蓝色亮度
-        uint8_t red  = 100 - blue;                    // 红色反向
-        led_control_set_color(red, blue);
-        k_msleep(BREATH_UPDATE_MS);                   // 丝滑刷新，每步10ms
-        }
-        break;
-    case LED_MODE_USER_BREATH: {
-        breath_cnt = (breath_cnt + 1) % BREATH_STEPS;
-        float phase = ((float)breath_cnt / (float)BREATH_STEPS) * 2.0f * M_PI;
- 
-        float raw = (sin(phase - M_PI/2) + 1.0f) / 2.0f;   // 0~1
-        float gamma = 2.0f;
-        raw = powf(raw, gamma);
- 
-        // 指定最小亮度
-        float min_level = 0.2f;              // 最小为20%
-        uint8_t red = (uint8_t)( (min_level + (1.0f - min_level)*raw) * 100 );
-        uint8_t blue = (uint8_t)(red * 0.3f);   // 粉色（红主蓝辅）
- 
-        led_control_set_color(red, blue);
-        k_msleep(BREATH_UPDATE_MS);
-        }
-        break;
+    return led_control_push_layer(layer, LED_MODE_OFF, 0, 0);
+}
+
+int led_control_set_mode(led_mode_t mode)
+{
+    return led_control_push_layer(LED_LAYER_BASE, mode, 255, 0);
+}
+
+// 计算一个图层在now时刻的颜色，返回距该层下一次变化的毫秒数；静态模式返回0
+static int led_layer_eval(const led_layer_t *l, int64_t now, uint16_t *red, uint16_t *blue)
+{
+    uint32_t elapsed = (uint32_t)(now - l->start_ms);
+    int step;
+    uint8_t r = 0, b = 0;
+
+    switch (l->mode) {
+    case LED_MODE_BREATH:
+        // 正弦+伽马校正的蓝色亮度，红色反向，表由构建脚本预先算好
+        step = (elapsed / BREATH_UPDATE_MS + 1) % BREATH_STEPS;
+        *red = led_breath_lut[step][0];
+        *blue = led_breath_lut[step][1];
+        return BREATH_UPDATE_MS - elapsed % BREATH_UPDATE_MS;   // 丝滑刷新，每步10ms
+    case LED_MODE_USER_BREATH:
+        // 粉色呼吸（红主蓝辅），最小亮度20%
+        step = (elapsed / BREATH_UPDATE_MS + 1) % BREATH_STEPS;
+        *red = led_user_breath_lut[step][0];
+        *blue = led_user_breath_lut[step][1];
+        return BREATH_UPDATE_MS - elapsed % BREATH_UPDATE_MS;
+    case LED_MODE_FLASH:
+        // 每250ms红蓝交替，先蓝后红
+        if ((elapsed / FLASH_PERIOD_MS) % 2) r = 100; else b = 100;
+        *red = LED_PERCENT_TO_DUTY(r);
+        *blue = LED_PERCENT_TO_DUTY(b);
+        return FLASH_PERIOD_MS - elapsed % FLASH_PERIOD_MS;
 
     case LED_MODE_RED:
-        led_control_set_color(100, 0); break;
+        r = 100; break;
     case LED_MODE_BLUE:
-        led_control_set_color(0, 100); break;
+        b = 100; break;
     case LED_MODE_PURPLE:
-        led_control_set_color(50, 50); break;
-    case LED_MODE_FLASH:
-        if (blink++ % 2)
-            led_control_set_color(100, 0);
-        else
-            led_control_set_color(0, 100);
-        k_msleep(250);   // 每250ms闪烁
-        break;
+        r = 50; b = 50; break;
     case LED_MODE_USER:
-        led_control_set_color(80, 60); break;
+        r = 80; b = 60; break;
     default:
-        led_control_set_color(0, 0); break;
+        break;
     }
+    *red = LED_PERCENT_TO_DUTY(r);
+    *blue = LED_PERCENT_TO_DUTY(b);
     return 0;
-}
\ No newline at end of file
+}
+
+static inline uint16_t blend(uint16_t under, uint16_t over, uint8_t alpha)
+{
+    return (uint16_t)(((uint32_t)under * (255 - alpha) + (uint32_t)over * alpha) / 255);
+}
+
+// 合成一帧并输出，返回距下一帧的毫秒数；所有可见层都静态且不会到期时返回0，不再唤醒
+static int led_compose_frame(void)
+{
+    led_layer_t snap[LED_LAYER_NUM];
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&layer_lock);
+
+    // 移除到期的层，取快照后在锁外合成；令牌随快照取走，本帧负责上报
+    for (int i = 0; i < LED_LAYER_NUM; i++) {
+        if (layers[i].alpha && layers[i].expire_ms && layers[i].expire_ms <= now) {
+            layers[i].alpha = 0;
+        }
+        snap[i] = layers[i];
+        layers[i].tag = 0;
+    }
+    k_spin_unlock(&layer_lock, key);
+
+    // 从最上面的不透明层开始往上叠，被完全遮住的层不计算也不唤醒
+    int bottom = 0;
+    for (int i = LED_LAYER_NUM - 1; i >= 0; i--) {
+        if (snap[i].alpha == 255) {
+            bottom = i;
+            break;
+        }
+    }
+
+    uint16_t red = 0, blue = 0;
+    int next_ms = 0;
+    for (int i = 0; i < LED_LAYER_NUM; i++) {
+        const led_layer_t *l = &snap[i];
+        uint16_t r, b;
+
+        if (i < bottom || l->alpha == 0) {
+            continue;
+        }
+        if (l->expire_ms) {
+            int left = (int)(l->expire_ms - now);
+            next_ms = next_ms ? MIN(next_ms, left) : left;
+        }
+        int layer_next = led_layer_eval(l, now, &r, &b);
+        if (layer_next > 0) {
+            next_ms = next_ms ? MIN(next_ms, layer_next) : layer_next;
+        }
+        red = blend(red, r, l->alpha);
+        blue = blend(blue, b, l->alpha);
+    }
+
+    frame_count++;
+    bool changed = led_write(red, blue);
+
+    // 带令牌的层参与了本帧且输出变了才算响应已输出
+    for (int i = 0; i < LED_LAYER_NUM; i++) {
+        if (snap[i].tag) {
+            input_latency_applied(snap[i].tag, changed && i >= bottom && snap[i].alpha);
+        }
+    }
+    return next_ms;
+}
+
+static void led_work_handler(struct k_work *work)
+{
+    STAGE_PROBE_BEGIN(t0);
+    int next_ms = led_compose_frame();
+    STAGE_PROBE_END(STAGE_LED_RENDER, t0);
+
+    if (next_ms > 0) {
+        output_sched_schedule(&led_work, K_MSEC(next_ms));
+    }
+}
+
+int led_control_periodic(void)
+{
+    return output_sched_reschedule(&led_work, K_NO_WAIT);
+}
+
+void led_control_get_stats(uint32_t *frames, uint32_t *writes)
+{
+    *frames = frame_count;
+    *writes = write_count;
+}
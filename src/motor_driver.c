@@ -4,78 +4,244 @@
 LOG_MODULE_REGISTER(motor_driver, LOG_LEVEL_INF);
 
 #include <zephyr/kernel.h>
-#include <zephyr/device.h>
-#include <zephyr/drivers/pwm.h>
-#include <zephyr/logging/log.h>
-#include "motor_driver.h"
+#include "input_bus.h"
+#include "output_sched.h"
+#include "pwm_out.h"
+#include "stage_probe.h"
 
-#define PWM_VIB DT_ALIAS(motor0)
+#define MOTOR_RAMP_TICK_MS  10      // 渐变步骤的刷新间隔
+#define MOTOR_NO_PATTERN    (-1)
 
-static const struct pwm_dt_spec pwm_vibrator = PWM_DT_SPEC_GET(PWM_VIB);
-static motor_vib_mode_t current_mode = MOTOR_VIB_HEARTBEAT;
+// 心跳模式
+static const motor_step_t heartbeat_steps[] = {
+	{ 95, 95, 60 },
+	{  0,  0, 80 },
+	{ 70, 70, 40 },
+	{  0,  0, 820 },
+};
 
-int motor_driver_init(void) {
-	// 可扩展初始化
-    return 0;
+// 轻拍模式
+static const motor_step_t tap_steps[] = {
+	{ 90, 90, 50 },
+	{  0,  0, 200 },
+};
+
+// 长震模式
+static const motor_step_t long_steps[] = {
+	{ 90, 90, 400 },
+	{  0,  0, 600 },
+};
+
+static const motor_pattern_t builtin_patterns[] = {
+	[MOTOR_VIB_HEARTBEAT] = { heartbeat_steps, ARRAY_SIZE(heartbeat_steps), MOTOR_REPEAT_FOREVER },
+	[MOTOR_VIB_TAP]       = { tap_steps, ARRAY_SIZE(tap_steps), MOTOR_REPEAT_FOREVER },
+	[MOTOR_VIB_LONG]      = { long_steps, ARRAY_SIZE(long_steps), MOTOR_REPEAT_FOREVER },
+};
+
+// 模式表：id即下标，MOTOR_VIB_OFF为NULL表示停振
+static const motor_pattern_t *patterns[MOTOR_PATTERN_MAX] = {
+	[MOTOR_VIB_HEARTBEAT] = &builtin_patterns[MOTOR_VIB_HEARTBEAT],
+	[MOTOR_VIB_TAP]       = &builtin_patterns[MOTOR_VIB_TAP],
+	[MOTOR_VIB_LONG]      = &builtin_patterns[MOTOR_VIB_LONG],
+};
+static int num_patterns = MOTOR_VIB_MODE_NUM;
+
+// ===== 播放状态（只在工作队列里访问）=====
+static const motor_pattern_t *cur_pat;
+static uint8_t cur_step;
+static uint8_t cur_loop;
+static uint16_t step_elapsed;
+static uint32_t resume_lag_us;      // 唤醒PWM控制器推迟的输出时间，从后面的停振步骤里扣回
+static uint8_t cur_duty;            // 当前输出的占空比(%)
+
+// ===== 请求（中断/线程写，工作队列读，seq_lock保护）=====
+static struct k_spinlock seq_lock;
+static int preempt_req = MOTOR_NO_PATTERN;
+static uint32_t preempt_tag;        // 随抢占请求的输入延迟令牌
+static int queue[MOTOR_QUEUE_LEN];
+static uint8_t queue_head, queue_len;
+
+static struct k_work_delayable seq_work;
+
+// 所有 role = "motor" 的通道同时输出，返回输出是否变化
+static bool motor_set_duty(uint8_t pct)
+{
+	bool changed = pct != cur_duty;
+
+	cur_duty = pct;
+	pwm_out_stage(PWM_OUT_MOTOR, (uint16_t)((pct * PWM_OUT_DUTY_MAX) / 100));
+	pwm_out_commit();
+	resume_lag_us += pwm_out_last_resume_us();
+	return changed;
 }
 
-int motor_driver_set_mode(motor_vib_mode_t mode) {
-	current_mode = mode;
+static void seq_load(int id)
+{
+	cur_pat = (id >= 0 && id < num_patterns) ? patterns[id] : NULL;
+	cur_step = 0;
+	cur_loop = 0;
+	step_elapsed = 0;
+	resume_lag_us = 0;
 }
 
-// 心跳模式
-static void vibrate_heartbeat(const struct pwm_dt_spec *pwm) {
-	// 使用设备树中的周期，只设置占空比
-	pwm_set_dt(pwm, pwm->period, (pwm->period * 95) / 100);  // 95%占空比
-	k_msleep(60);
-	pwm_set_dt(pwm, pwm->period, 0);  // 关闭
-	k_msleep(80);
-	pwm_set_dt(pwm, pwm->period, (pwm->period * 70) / 100);  // 70%占空比
-	k_msleep(40);
-	pwm_set_dt(pwm, pwm->period, 0);
-	k_msleep(820);
+// 当前模式播完：取队列里的下一个，没有则停振
+static void seq_next_from_queue(void)
+{
+	int id = MOTOR_VIB_OFF;
+	k_spinlock_key_t key = k_spin_lock(&seq_lock);
+
+	if (queue_len > 0) {
+		id = queue[queue_head];
+		queue_head = (queue_head + 1) % MOTOR_QUEUE_LEN;
+		queue_len--;
+	}
+	k_spin_unlock(&seq_lock, key);
+	seq_load(id);
 }
 
-// 轻拍模式
-static void vibrate_tap(const struct pwm_dt_spec *pwm) {
-	pwm_set_dt(pwm, pwm->period, (pwm->period * 90) / 100);  // 90%占空比
-	k_msleep(50);
-	pwm_set_dt(pwm, pwm->period, 0);
-	k_msleep(200);
+// 推进序列：处理抢占请求、跳过播完的步骤并输出当前占空比
+static void seq_step(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&seq_lock);
+	int req = preempt_req;
+	uint32_t tag = preempt_tag;
+
+	preempt_req = MOTOR_NO_PATTERN;
+	preempt_tag = 0;
+	k_spin_unlock(&seq_lock, key);
+
+	if (req != MOTOR_NO_PATTERN) {
+		seq_load(req);
+	} else if (!cur_pat) {
+		seq_next_from_queue();
+	}
+
+	// 推进已经播完的步骤
+	while (cur_pat && step_elapsed >= cur_pat->steps[cur_step].duration_ms) {
+		step_elapsed = 0;
+		if (++cur_step < cur_pat->num_steps) {
+			continue;
+		}
+		cur_step = 0;
+		if (cur_pat->repeat != MOTOR_REPEAT_FOREVER && ++cur_loop >= cur_pat->repeat) {
+			seq_next_from_queue();
+		}
+	}
+
+	if (!cur_pat) {
+		bool changed = motor_set_duty(0);
+		if (tag) {
+			input_latency_applied(tag, changed);
+		}
+		return;
+	}
+
+	const motor_step_t *step = &cur_pat->steps[cur_step];
+	uint16_t wait = step->duration_ms - step_elapsed;
+	uint8_t duty = step->duty_start;
+
+	if (step->duty_end != step->duty_start) {
+		duty = step->duty_start +
+		       ((int)step->duty_end - step->duty_start) * step_elapsed / step->duration_ms;
+		wait = MIN(wait, MOTOR_RAMP_TICK_MS);
+	}
+	bool changed = motor_set_duty(duty);
+	if (tag) {
+		input_latency_applied(tag, changed);
+	}
+
+	step_elapsed += wait;
+	// 振动脉冲保持完整长度，唤醒控制器的耗时在停振间隔里扣回，循环模式的节拍不漂移
+	if (duty == 0 && resume_lag_us >= USEC_PER_MSEC) {
+		uint16_t comp = MIN(resume_lag_us / USEC_PER_MSEC, wait - 1U);
+		wait -= comp;
+		resume_lag_us -= comp * USEC_PER_MSEC;
+	}
+	output_sched_schedule(&seq_work, K_MSEC(wait));
 }
 
-// 长震模式
-static void vibrate_long(const struct pwm_dt_spec *pwm) {
-	pwm_set_dt(pwm, pwm->period, (pwm->period * 90) / 100);
-	k_msleep(400);
-	pwm_set_dt(pwm, pwm->period, 0);
-	k_msleep(600);
+static void seq_work_handler(struct k_work *work)
+{
+	STAGE_PROBE_BEGIN(t0);
+	seq_step();
+	STAGE_PROBE_END(STAGE_MOTOR_STEP, t0);
 }
 
-// 关闭模式
-static void vibrate_stop(const struct pwm_dt_spec *pwm) {
-	pwm_set_dt(pwm, pwm->period, 0);
+int motor_driver_init(void) {
+	if (pwm_out_role_channels(PWM_OUT_MOTOR) == 0) {
+		LOG_ERR("No PWM vibrator channel in devicetree!");
+		return -ENODEV;
+	}
+	k_work_init_delayable(&seq_work, seq_work_handler);
+	return motor_driver_set_mode(MOTOR_VIB_HEARTBEAT);
 }
 
-int motor_driver_periodic(void) {
-	if (!device_is_ready(pwm_vibrator.dev)) {
-		LOG_ERR("PWM vibrator device not ready!");
-		k_msleep(1000);
-		return;
+int motor_driver_register_pattern(const motor_pattern_t *pattern) {
+	if (!pattern || pattern->num_steps == 0) {
+		return -EINVAL;
 	}
-	switch (current_mode) {
-		case MOTOR_VIB_HEARTBEAT:
-			vibrate_heartbeat(&pwm_vibrator);
-			break;
-		case MOTOR_VIB_TAP:
-			vibrate_tap(&pwm_vibrator);
-			break;
-		case MOTOR_VIB_LONG:
-			vibrate_long(&pwm_vibrator);
-			break;
-		default:
-            vibrate_stop(&pwm_vibrator);
-			break;
+	for (int i = 0; i < pattern->num_steps; i++) {
+		if (pattern->steps[i].duration_ms == 0 ||
+		    pattern->steps[i].duty_start > 100 || pattern->steps[i].duty_end > 100) {
+			return -EINVAL;
+		}
 	}
-    return 0;
+
+	k_spinlock_key_t key = k_spin_lock(&seq_lock);
+	int id = -ENOMEM;
+
+	if (num_patterns < MOTOR_PATTERN_MAX) {
+		id = num_patterns;
+		patterns[num_patterns++] = pattern;
+	}
+	k_spin_unlock(&seq_lock, key);
+	return id;
+}
+
+static int play(int id, bool preempt, uint32_t tag) {
+	if (id < 0 || id >= num_patterns) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&seq_lock);
+	int ret = 0;
+
+	if (preempt) {
+		preempt_req = id;
+		preempt_tag = tag;
+		queue_len = 0;
+	} else if (queue_len < MOTOR_QUEUE_LEN) {
+		queue[(queue_head + queue_len) % MOTOR_QUEUE_LEN] = id;
+		queue_len++;
+	} else {
+		ret = -EBUSY;
+	}
+	k_spin_unlock(&seq_lock, key);
+
+	if (ret == 0) {
+		if (preempt) {
+			// 立即重新调度，新占空比在下一个PWM周期生效
+			output_sched_reschedule(&seq_work, K_NO_WAIT);
+		} else {
+			// 空闲时才需要唤醒，正在播放则等当前模式结束
+			output_sched_schedule(&seq_work, K_NO_WAIT);
+		}
+	}
+	return ret;
+}
+
+int motor_driver_play(int id, bool preempt) {
+	return play(id, preempt, 0);
+}
+
+int motor_driver_play_tagged(int id, uint32_t tag) {
+	return play(id, true, tag);
+}
+
+int motor_driver_set_mode(motor_vib_mode_t mode) {
+	return motor_driver_play(mode, true);
+}
+
+int motor_driver_periodic(void) {
+	return 0;
 }
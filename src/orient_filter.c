@@ -0,0 +1,98 @@
+#include "orient_filter.h"
+#include <string.h>
+
+#define G_SHIFT             22
+#define G_ONE               (1 << G_SHIFT)
+// 每个陀螺仪计数·毫秒对应的弧度（Q30）：pi/180 / 32.8 / 1000 * 2^30
+#define GYRO_RAD_Q30        571
+#define ACC_GATE_Q          ((int32_t)(ORIENT_ACC_GATE * ACCEL_SCALE))
+
+// 逐位整数开方
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+static uint32_t norm3(int64_t x, int64_t y, int64_t z)
+{
+    return isqrt64((uint64_t)(x * x + y * y + z * z));
+}
+
+void orient_filter_init(OrientFilter *f)
+{
+    memset(f, 0, sizeof(*f));
+}
+
+void orient_filter_update(OrientFilter *f, const ImuSample *s)
+{
+    const int32_t a[3] = { s->acc.ax, s->acc.ay, s->acc.az };
+    uint32_t amag = norm3(a[0], a[1], a[2]);
+
+    f->rate_dps = (int32_t)(norm3(s->gx, s->gy, s->gz) * 10 / SCK_MPU6050_GYRO_COUNTS_PER_DPS_X10);
+
+    if (!f->init) {
+        if (amag == 0) return;
+        for (int i = 0; i < 3; i++) {
+            f->g[i] = (int32_t)((int64_t)a[i] * G_ONE / amag);
+        }
+        f->last_ts = s->acc.ts;
+        f->init = true;
+        return;
+    }
+
+    int64_t dt = s->acc.ts - f->last_ts;
+    if (dt < 0) dt = 0;
+    if (dt > ORIENT_DT_MAX_MS) dt = ORIENT_DT_MAX_MS;
+    f->last_ts = s->acc.ts;
+
+    // 预测：重力在机体系中反向转动，dg/dt = g x w（小角度一步积分）
+    const int64_t th[3] = {
+        (int64_t)s->gx * dt * GYRO_RAD_Q30,
+        (int64_t)s->gy * dt * GYRO_RAD_Q30,
+        (int64_t)s->gz * dt * GYRO_RAD_Q30,
+    };
+    const int64_t p[3] = { f->g[0], f->g[1], f->g[2] };
+    int64_t g[3] = {
+        p[0] + ((p[1] * th[2] - p[2] * th[1]) >> 30),
+        p[1] + ((p[2] * th[0] - p[0] * th[2]) >> 30),
+        p[2] + ((p[0] * th[1] - p[1] * th[0]) >> 30),
+    };
+
+    // 校正：只有加速度基本只含重力时才相信它的方向（敲击、甩手时跳过）。
+    // 校正比例按样本间隔缩放，参考周期下正好是 >> ORIENT_ACC_SHIFT
+    int32_t dev = (int32_t)amag - (int32_t)ACCEL_SCALE;
+    if (amag && (dev < 0 ? -dev : dev) < ACC_GATE_Q) {
+        int64_t gain = (dt << 16) / (ORIENT_ACC_REF_MS << ORIENT_ACC_SHIFT);    // Q16
+        for (int i = 0; i < 3; i++) {
+            int64_t au = (int64_t)a[i] * G_ONE / amag;
+            g[i] += ((au - g[i]) * gain) >> 16;
+        }
+    }
+
+    // 归一化，防止积分误差累积改变模长
+    uint32_t n = norm3(g[0], g[1], g[2]);
+    if (n == 0) return;
+    for (int i = 0; i < 3; i++) {
+        f->g[i] = (int32_t)(g[i] * G_ONE / n);
+    }
+}
+
+void orient_filter_gravity(const OrientFilter *f, int16_t out[3])
+{
+    for (int i = 0; i < 3; i++) {
+        out[i] = (int16_t)(f->g[i] >> (G_SHIFT - 14));   // ACCEL_SCALE = 2^14
+    }
+}
@@ -0,0 +1,34 @@
+#include "output_sched.h"
+
+#ifdef CONFIG_APP_OUTPUT_STACK_SIZE
+#define OUTPUT_SCHED_STACK_SIZE CONFIG_APP_OUTPUT_STACK_SIZE
+#else
+#define OUTPUT_SCHED_STACK_SIZE 768     // 不带应用Kconfig的构建（bench）
+#endif
+#define OUTPUT_SCHED_PRIORITY   5
+
+K_THREAD_STACK_DEFINE(output_sched_stack, OUTPUT_SCHED_STACK_SIZE);
+static struct k_work_q output_workq;
+
+int output_sched_init(void)
+{
+    const struct k_work_queue_config cfg = {
+        .name = "output_sched",
+    };
+
+    k_work_queue_init(&output_workq);
+    k_work_queue_start(&output_workq, output_sched_stack,
+                       K_THREAD_STACK_SIZEOF(output_sched_stack),
+                       OUTPUT_SCHED_PRIORITY, &cfg);
+    return 0;
+}
+
+int output_sched_schedule(struct k_work_delayable *dwork, k_timeout_t delay)
+{
+    return k_work_schedule_for_queue(&output_workq, dwork, delay);
+}
+
+int output_sched_reschedule(struct k_work_delayable *dwork, k_timeout_t delay)
+{
+    return k_work_reschedule_for_queue(&output_workq, dwork, delay);
+}
@@ -0,0 +1,383 @@
+#include "pwm_out.h"
+#include <errno.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/kernel.h>
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+#include <zephyr/pm/device_runtime.h>
+#endif
+#include "output_sched.h"
+
+#define DT_DRV_COMPAT sck_pwm_outputs
+
+#define PWM_OUT_NO_CTRL UINT8_MAX   // 控制器未就绪，不参与提交
+
+#ifdef CONFIG_APP_PWM_PM_IDLE_MS
+#define PWM_OUT_PM_IDLE_MS CONFIG_APP_PWM_PM_IDLE_MS
+#else
+#define PWM_OUT_PM_IDLE_MS 20       // 不带应用Kconfig的构建（bench）
+#endif
+
+struct pwm_out_chan {
+    struct pwm_dt_spec spec;
+    const char *name;
+    uint8_t role;
+    uint8_t ctrl;           // 同一控制器第一个就绪通道的下标，按它分组提交
+    uint16_t duty;
+};
+
+#define PWM_OUT_CHAN(node)                                              \
+    {                                                                   \
+        .spec = PWM_DT_SPEC_GET(node),                                  \
+        .name = DT_PROP_OR(node, label, DT_NODE_FULL_NAME(node)),       \
+        .role = DT_ENUM_IDX(node, role),                                \
+    },
+#define PWM_OUT_GROUP(inst) DT_INST_FOREACH_CHILD_STATUS_OKAY(inst, PWM_OUT_CHAN)
+
+static struct pwm_out_chan chans[] = {
+    DT_INST_FOREACH_STATUS_OKAY(PWM_OUT_GROUP)
+};
+
+BUILD_ASSERT(ARRAY_SIZE(chans) <= PWM_OUT_MAX_CHANNELS, "too many PWM output channels");
+
+// ===== 暂存状态（stage/commit 共用，lock保护）=====
+static struct k_spinlock lock;
+static uint32_t dirty;
+// 串行化硬件写入（及运行时PM状态），PWM驱动调用可能阻塞，不能放在lock里
+static K_MUTEX_DEFINE(commit_lock);
+
+// 16位占空比换算成脉宽，周期为ns量级需用64位乘法
+static inline uint32_t duty_to_pulse(const struct pwm_dt_spec *spec, uint16_t duty)
+{
+    return (uint32_t)(((uint64_t)spec->period * duty) / PWM_OUT_DUTY_MAX);
+}
+
+// ===== 控制器运行时电源管理（commit_lock保护，下标为控制器第一个通道）=====
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+struct pwm_out_pm {
+    bool enabled;           // 控制器驱动支持运行时PM
+    bool held;              // 持有runtime引用，控制器在工作
+    bool idle;              // 所有通道已归零，等待挂起
+    uint16_t hold_ms;       // 归零后多久挂起
+    int64_t idle_since;
+    struct pwm_out_pm_stats stats;
+};
+
+static struct pwm_out_pm pm[ARRAY_SIZE(chans)];
+static uint32_t last_resume_us;
+
+static void pm_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(pm_work, pm_work_handler);
+
+static inline bool ctrl_powered(int c)
+{
+    return pm[c].held;
+}
+
+// 控制器上是否有通道在输出（lock内调用）
+static bool ctrl_active(int c)
+{
+    for (int i = c; i < ARRAY_SIZE(chans); i++) {
+        if (chans[i].ctrl == c && chans[i].duty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 开启运行时PM并保持控制器工作，初始化写完0占空比后由 pm_update_idle 挂起
+static void pm_init_ctrl(int c)
+{
+    const struct device *dev = chans[c].spec.dev;
+    uint32_t period_ns = 0;
+
+    for (int i = c; i < ARRAY_SIZE(chans); i++) {
+        if (chans[i].ctrl == c) {
+            period_ns = MAX(period_ns, chans[i].spec.period);
+        }
+    }
+    // 0占空比在下一个周期起点才装载，至少等一个周期再挂起，最后一个脉冲不被截断
+    pm[c].hold_ms = MAX(PWM_OUT_PM_IDLE_MS, DIV_ROUND_UP(period_ns, NSEC_PER_MSEC));
+    pm[c].held = true;
+
+    int ret = pm_device_runtime_enable(dev);
+    if (ret == 0) {
+        ret = pm_device_runtime_get(dev);
+    }
+    if (ret != 0) {
+        printk("PWM %s: runtime PM unavailable (%d), stays on\n", dev->name, ret);
+        return;
+    }
+    pm[c].enabled = true;
+}
+
+// 有通道要输出而控制器已挂起：先唤醒，挂起期间寄存器不保留，该控制器的通道全部标脏重写。
+// 返回唤醒花费的时间(us)
+static uint32_t pm_resume_active(void)
+{
+    uint32_t spent_us = 0;
+
+    for (int c = 0; c < ARRAY_SIZE(chans); c++) {
+        if (chans[c].ctrl != c || pm[c].held) {
+            continue;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        bool want = ctrl_active(c);
+        k_spin_unlock(&lock, key);
+        if (!want) {
+            continue;
+        }
+
+        uint32_t t0 = k_cycle_get_32();
+        int ret = pm_device_runtime_get(chans[c].spec.dev);
+        uint32_t us = k_cyc_to_us_ceil32(k_cycle_get_32() - t0);
+
+        if (ret != 0) {
+            pm[c].stats.errors++;
+            continue;
+        }
+        pm[c].held = true;
+        pm[c].stats.resumes++;
+        pm[c].stats.last_resume_us = us;
+        pm[c].stats.max_resume_us = MAX(pm[c].stats.max_resume_us, us);
+        spent_us += us;
+
+        key = k_spin_lock(&lock);
+        for (int i = c; i < ARRAY_SIZE(chans); i++) {
+            if (chans[i].ctrl == c) {
+                dirty |= BIT(i);
+            }
+        }
+        k_spin_unlock(&lock, key);
+    }
+    return spent_us;
+}
+
+static void pm_suspend(int c)
+{
+    if (pm_device_runtime_put(chans[c].spec.dev) != 0) {
+        pm[c].stats.errors++;
+        return;
+    }
+    pm[c].held = false;
+    pm[c].idle = false;
+    pm[c].stats.suspends++;
+}
+
+// 所有通道归零的控制器计时，到期的挂起，其余按最早到期时间重新调度
+static void pm_update_idle(void)
+{
+    int64_t now = k_uptime_get();
+    int next_ms = -1;
+
+    for (int c = 0; c < ARRAY_SIZE(chans); c++) {
+        if (chans[c].ctrl != c || !pm[c].enabled || !pm[c].held) {
+            continue;
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        bool active = ctrl_active(c);
+        k_spin_unlock(&lock, key);
+        if (active) {
+            pm[c].idle = false;
+            continue;
+        }
+        if (!pm[c].idle) {
+            pm[c].idle = true;
+            pm[c].idle_since = now;
+        }
+
+        int left = (int)(pm[c].idle_since + pm[c].hold_ms - now);
+        if (left <= 0) {
+            pm_suspend(c);
+        } else {
+            next_ms = next_ms < 0 ? left : MIN(next_ms, left);
+        }
+    }
+    if (next_ms >= 0) {
+        output_sched_reschedule(&pm_work, K_MSEC(next_ms));
+    }
+}
+
+static void pm_work_handler(struct k_work *work)
+{
+    k_mutex_lock(&commit_lock, K_FOREVER);
+    pm_update_idle();
+    k_mutex_unlock(&commit_lock);
+}
+#else
+static inline bool ctrl_powered(int c)
+{
+    return true;
+}
+#endif
+
+int pwm_out_init(void)
+{
+    int ret = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(chans); i++) {
+        struct pwm_out_chan *ch = &chans[i];
+
+        ch->ctrl = PWM_OUT_NO_CTRL;
+        if (!device_is_ready(ch->spec.dev)) {
+            printk("PWM output %s: controller not ready\n", ch->name);
+            ret = -ENODEV;
+            continue;
+        }
+        ch->ctrl = i;
+        for (int j = 0; j < i; j++) {
+            if (chans[j].spec.dev == ch->spec.dev) {
+                ch->ctrl = chans[j].ctrl;
+                break;
+            }
+        }
+        printk("PWM output %s: %s ch%u period %u ns\n", ch->name, ch->spec.dev->name,
+               ch->spec.channel, ch->spec.period);
+    }
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    for (int c = 0; c < ARRAY_SIZE(chans); c++) {
+        if (chans[c].ctrl == c) {
+            pm_init_ctrl(c);
+        }
+    }
+#endif
+    for (int i = 0; i < ARRAY_SIZE(chans); i++) {
+        if (chans[i].ctrl != PWM_OUT_NO_CTRL) {
+            chans[i].duty = 0;
+            pwm_set_dt(&chans[i].spec, chans[i].spec.period, 0);
+        }
+    }
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    k_mutex_lock(&commit_lock, K_FOREVER);
+    pm_update_idle();
+    k_mutex_unlock(&commit_lock);
+#endif
+    return ret;
+}
+
+void pwm_out_stage(pwm_out_role_t role, uint16_t duty)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    for (int i = 0; i < ARRAY_SIZE(chans); i++) {
+        if (chans[i].role == role && chans[i].duty != duty) {
+            chans[i].duty = duty;
+            dirty |= BIT(i);
+        }
+    }
+    k_spin_unlock(&lock, key);
+}
+
+int pwm_out_commit(void)
+{
+    struct {
+        uint8_t chan;
+        uint32_t pulse;
+    } writes[ARRAY_SIZE(chans)];
+    int n = 0;
+    int ret = 0;
+
+    k_mutex_lock(&commit_lock, K_FOREVER);
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    last_resume_us = pm_resume_active();
+#endif
+
+    // lock内只取走变化的占空比，按控制器分组排好
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint32_t pending = dirty;
+
+    dirty = 0;
+    for (int c = 0; pending && c < ARRAY_SIZE(chans); c++) {
+        if (chans[c].ctrl != c) {
+            continue;
+        }
+        for (int i = c; i < ARRAY_SIZE(chans); i++) {
+            const struct pwm_out_chan *ch = &chans[i];
+
+            if (ch->ctrl != c || !(pending & BIT(i))) {
+                continue;
+            }
+            pending &= ~BIT(i);
+            if (!ctrl_powered(c)) {
+                // 挂起的控制器输出本来就是关的，唤醒时整组重写；
+                // 唤醒之后才暂存的非0值留给下一次commit
+                if (ch->duty) {
+                    dirty |= BIT(i);
+                }
+                continue;
+            }
+            writes[n].chan = i;
+            writes[n].pulse = duty_to_pulse(&ch->spec, ch->duty);
+            n++;
+        }
+    }
+    k_spin_unlock(&lock, key);
+
+    // 锁外按控制器连续写。API每次只写一个通道，锁调度器让高优先级线程插不进来，
+    // 同一控制器的通道多数情况下在同一周期装载；中断仍可能让它们跨过周期边界，
+    // 0%/100%（pwm_nrfx走GPIO）立即生效，所以只是尽力而为
+    k_sched_lock();
+    for (int k = 0; k < n; k++) {
+        const struct pwm_dt_spec *spec = &chans[writes[k].chan].spec;
+        int err = pwm_set_dt(spec, spec->period, writes[k].pulse);
+
+        if (err && !ret) {
+            ret = err;
+        }
+    }
+    k_sched_unlock();
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    pm_update_idle();
+#endif
+    k_mutex_unlock(&commit_lock);
+    return ret ? ret : n;
+}
+
+int pwm_out_role_channels(pwm_out_role_t role)
+{
+    int n = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(chans); i++) {
+        n += chans[i].role == role;
+    }
+    return n;
+}
+
+uint32_t pwm_out_last_resume_us(void)
+{
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    return last_resume_us;
+#else
+    return 0;
+#endif
+}
+
+int pwm_out_get_pm_stats(pwm_out_role_t role, struct pwm_out_pm_stats *out)
+{
+    for (int i = 0; i < ARRAY_SIZE(chans); i++) {
+        if (chans[i].role != role || chans[i].ctrl == PWM_OUT_NO_CTRL) {
+            continue;
+        }
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+        int c = chans[i].ctrl;
+
+        if (!pm[c].enabled) {
+            return -ENOTSUP;
+        }
+        k_mutex_lock(&commit_lock, K_FOREVER);
+        *out = pm[c].stats;
+        out->suspended = !pm[c].held;
+        k_mutex_unlock(&commit_lock);
+        return 0;
+#else
+        ARG_UNUSED(out);
+        return -ENOTSUP;
+#endif
+    }
+    return -ENODEV;
+}
@@ -0,0 +1,99 @@
+#include "rate_governor.h"
+#include <string.h>
+
+#define MG_TO_COUNTS(mg)    ((int32_t)((mg) * (int32_t)ACCEL_SCALE / 1000))
+
+static int32_t abs32(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+// 相邻两个样本任一轴变化超过阈值
+static bool is_spike(const int16_t prev[3], const AccelSample *s, int32_t th)
+{
+    return abs32(s->ax - prev[0]) > th || abs32(s->ay - prev[1]) > th ||
+           abs32(s->az - prev[2]) > th;
+}
+
+void rate_governor_default_cfg(RateGovernorCfg *cfg)
+{
+    cfg->low_hz = RG_LOW_HZ_DEFAULT;
+    cfg->high_hz = RG_HIGH_HZ_DEFAULT;
+    cfg->hold_ms = RG_HOLD_MS_DEFAULT;
+    cfg->wake_th = MG_TO_COUNTS(RG_WAKE_MG_DEFAULT);
+}
+
+void rate_governor_init(RateGovernor *rg, const RateGovernorCfg *cfg, int64_t now)
+{
+    memset(rg, 0, sizeof(*rg));
+    rg->cfg = *cfg;
+    rg->hz = cfg->high_hz;
+    rg->busy_ts = now;
+    rg->state_since = now;
+}
+
+int rate_governor_feed(RateGovernor *rg, const AccelSample *s, bool idle)
+{
+    bool spike = rg->have_prev && is_spike(rg->prev, s, rg->cfg.wake_th);
+
+    rg->prev[0] = s->ax;
+    rg->prev[1] = s->ay;
+    rg->prev[2] = s->az;
+    rg->have_prev = true;
+    rg->samples++;
+
+    if (!idle || spike) {
+        rg->busy_ts = s->ts;
+    }
+    if (rg->hz != rg->cfg.high_hz) {
+        // 低速档只看突变：检测器在低采样率下的空闲判断可能滞后一个窗口
+        return spike ? rg->cfg.high_hz : 0;
+    }
+    if (s->ts - rg->busy_ts >= rg->cfg.hold_ms) {
+        return rg->cfg.low_hz;
+    }
+    return 0;
+}
+
+void rate_governor_commit(RateGovernor *rg, int hz, int64_t now)
+{
+    int64_t dt = now - rg->state_since;
+
+    if (hz == rg->hz) {
+        return;
+    }
+    if (rg->hz == rg->cfg.high_hz) {
+        rg->high_ms += dt;
+    } else {
+        rg->low_ms += dt;
+    }
+    if (hz == rg->cfg.high_hz) {
+        rg->ramps++;
+        rg->busy_ts = now;      // 升速后至少保持 hold_ms
+    }
+    rg->hz = hz;
+    rg->state_since = now;
+}
+
+void rate_governor_report(const RateGovernor *rg, int64_t now, RateGovernorReport *r)
+{
+    int64_t low = rg->low_ms;
+    int64_t high = rg->high_ms;
+
+    if (rg->hz == rg->cfg.high_hz) {
+        high += now - rg->state_since;
+    } else {
+        low += now - rg->state_since;
+    }
+    int64_t total = low + high;
+
+    memset(r, 0, sizeof(*r));
+    r->samples = rg->samples;
+    r->ramps = rg->ramps;
+    if (total <= 0) {
+        r->avg_hz_x10 = (uint32_t)rg->hz * 10;
+        return;
+    }
+    r->avg_hz_x10 = (uint32_t)((low * rg->cfg.low_hz + high * rg->cfg.high_hz) * 10 / total);
+    r->high_permille = (uint32_t)(high * 1000 / total);
+}
@@ -0,0 +1,36 @@
+#include "stack_report.h"
+#include "report_out.h"
+#include <zephyr/kernel.h>
+
+static void stack_cb(const struct k_thread *cthread, void *user_data)
+{
+    const struct shell *sh = user_data;
+    struct k_thread *thread = (struct k_thread *)cthread;
+    const char *name = k_thread_name_get(thread);
+    size_t size = thread->stack_info.size;
+    size_t unused;
+
+    if (k_thread_stack_space_get(thread, &unused) != 0) {
+        return;
+    }
+    REPORT_OUT(sh, "stack,%s,%u,%u", name ? name : "?", (unsigned int)size,
+               (unsigned int)(size - unused));
+}
+
+// 回调里会 shell_print/printk，不能持有线程链表锁
+void stack_report_dump(void)
+{
+    k_thread_foreach_unlocked(stack_cb, NULL);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_stacks(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    k_thread_foreach_unlocked(stack_cb, (void *)sh);
+    return 0;
+}
+
+SHELL_CMD_REGISTER(stacks, NULL, "Thread stack high-water marks (CSV lines)", cmd_stacks);
+#endif
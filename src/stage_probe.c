@@ -0,0 +1,182 @@
+#include "stage_probe.h"
+#include "report_out.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+static const char *const stage_names[STAGE_NUM] = {
+    [STAGE_I2C_READ]   = "i2c_read",
+    [STAGE_DETECT]     = "detect",
+    [STAGE_LED_RENDER] = "led_render",
+    [STAGE_MOTOR_STEP] = "motor_step",
+};
+
+static stage_stats_t stats[STAGE_NUM];
+static struct k_spinlock stats_lock;
+
+void stage_probe_record(stage_id_t stage, uint32_t cycles)
+{
+    int bucket = 31 - __builtin_clz(cycles | 1);
+    stage_stats_t *s = &stats[stage];
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    if (s->count == 0 || cycles < s->min) {
+        s->min = cycles;
+    }
+    if (cycles > s->max) {
+        s->max = cycles;
+    }
+    s->count++;
+    s->sum += cycles;
+    s->hist[MIN(bucket, STAGE_HIST_BUCKETS - 1)]++;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+int stage_probe_get(stage_id_t stage, stage_stats_t *out)
+{
+    if (stage >= STAGE_NUM) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    *out = stats[stage];
+    k_spin_unlock(&stats_lock, key);
+    return 0;
+}
+
+void stage_probe_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    memset(stats, 0, sizeof(stats));
+    k_spin_unlock(&stats_lock, key);
+}
+
+const char *stage_probe_name(stage_id_t stage)
+{
+    return stage < STAGE_NUM ? stage_names[stage] : "?";
+}
+
+static uint32_t cyc_to_ns(uint64_t cyc)
+{
+    return (uint32_t)k_cyc_to_ns_floor64(cyc);
+}
+
+// ===== 线程CPU占用 =====
+struct thread_walk {
+    const struct shell *sh;
+    uint64_t total;
+    bool csv;
+};
+
+static void thread_usage_cb(const struct k_thread *cthread, void *user_data)
+{
+    struct thread_walk *w = user_data;
+    struct k_thread *thread = (struct k_thread *)cthread;
+    k_thread_runtime_stats_t rt;
+    const char *name = k_thread_name_get(thread);
+    uint32_t permille;
+
+    if (k_thread_runtime_stats_get(thread, &rt) != 0) {
+        return;
+    }
+    permille = w->total ? (uint32_t)(rt.execution_cycles * 1000 / w->total) : 0;
+
+    if (w->csv) {
+        REPORT_OUT(w->sh, "thread,%s,%llu,%u", name ? name : "?",
+                   (unsigned long long)rt.execution_cycles, permille);
+    } else {
+        REPORT_OUT(w->sh, "  %-16s %3u.%u%%", name ? name : "?", permille / 10, permille % 10);
+    }
+}
+
+static void walk_threads(const struct shell *sh, bool csv)
+{
+    k_thread_runtime_stats_t all;
+    struct thread_walk w = { .sh = sh, .csv = csv };
+
+    if (k_thread_runtime_stats_all_get(&all) == 0) {
+        w.total = all.execution_cycles;
+    }
+    if (csv) {
+        REPORT_OUT(sh, "cpu,%llu", (unsigned long long)w.total);
+    }
+    // 回调里会 shell_print/printk，不能持有线程链表锁（同 kernel threads 命令）
+    k_thread_foreach_unlocked(thread_usage_cb, &w);
+}
+
+// ===== 输出 =====
+// 机器可读格式，每行一条记录，字段顺序固定：
+//   stage,<name>,<count>,<min_cyc>,<max_cyc>,<mean_cyc>,<h0>..<h15>
+//   cpu,<total_cyc>
+//   thread,<name>,<cycles>,<permille>
+static void dump_csv(const struct shell *sh)
+{
+    REPORT_OUT(sh, "cycles_per_sec,%u", sys_clock_hw_cycles_per_sec());
+    for (int i = 0; i < STAGE_NUM; i++) {
+        stage_stats_t s;
+        char hist[STAGE_HIST_BUCKETS * 11 + 1];
+        int pos = 0;
+
+        stage_probe_get(i, &s);
+        for (int b = 0; b < STAGE_HIST_BUCKETS; b++) {
+            pos += snprintk(&hist[pos], sizeof(hist) - pos, ",%u", s.hist[b]);
+        }
+        REPORT_OUT(sh, "stage,%s,%u,%u,%u,%u%s", stage_names[i], s.count, s.min, s.max,
+                   s.count ? (uint32_t)(s.sum / s.count) : 0, hist);
+    }
+    walk_threads(sh, true);
+}
+
+static void show_table(const struct shell *sh)
+{
+    REPORT_OUT(sh, "  %-12s %8s %9s %9s %9s", "stage", "count", "min(ns)", "mean(ns)", "max(ns)");
+    for (int i = 0; i < STAGE_NUM; i++) {
+        stage_stats_t s;
+
+        stage_probe_get(i, &s);
+        REPORT_OUT(sh, "  %-12s %8u %9u %9u %9u", stage_names[i], s.count,
+                   cyc_to_ns(s.min), s.count ? cyc_to_ns(s.sum / s.count) : 0, cyc_to_ns(s.max));
+    }
+    REPORT_OUT(sh, "  thread CPU usage:");
+    walk_threads(sh, false);
+}
+
+void stage_probe_dump(void)
+{
+    dump_csv(NULL);
+}
+
+// ===== shell命令: stats show | dump | reset =====
+static int cmd_stats_show(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    show_table(sh);
+    return 0;
+}
+
+static int cmd_stats_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    dump_csv(sh);
+    return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    stage_probe_reset();
+    shell_print(sh, "stage stats cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_stats,
+    SHELL_CMD(show, NULL, "Per-stage timing and thread CPU usage", cmd_stats_show),
+    SHELL_CMD(dump, NULL, "Machine-readable dump (CSV lines)", cmd_stats_dump),
+    SHELL_CMD(reset, NULL, "Clear stage statistics", cmd_stats_reset),
+    SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(stats, &sub_stats, "Hot-path stage timing", NULL);
@@ -0,0 +1,1117 @@
+#include "tap_detector.h"
+#include "accel_block.h"
+#include "tap_log.h"
+#include "tap_params.h"
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+// 可调阈值的默认值在 tap_params.h，运行时可用 tap_detector_set_params 替换
+#define DOUBLE_TAP_COOLDOWN 1000    // 连击事件冷却
+
+// ===== 晃动/静止手势默认参数 =====
+#define SHAKE_TH_MG         600     // 模长偏离重力参考超过此值记一次
+#define SHAKE_COUNT         4       // 窗口内次数
+#define SHAKE_WINDOW_MS     1000
+#define HOLD_STILL_MS       3000    // 姿态稳定持续时间
+
+// ===== 滑动检测参数 =====
+#define CALIBRATION_SAMPLES 50      // 自校准样本数（按参考周期抽样）
+#define WIN_STEP_MIN_MS     (SAMPLING_INTERVAL_MS * 3 / 4)  // 静止窗口抽样间隔下限，容忍时间戳抖动
+
+// 旋转伪敲击抑制参数（需要 tap_detector_set_attitude 输入）
+#define ROT_RATE_REJECT_DPS 250     // 敲击期间角速度峰值上限（°/s），快速转腕通常远超此值
+#define ROT_TILT_COS_X1000  940     // 敲击前后重力方向夹角余弦下限（约20°）
+
+// ===== 常量定义 =====
+#define STAT_WIN_INIT_MIN   999.0f
+#define STAT_WIN_INIT_MAX  -999.0f
+#define GRAVITY_NOMINAL     1.0f
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// ===== 日志 =====
+// 级别在编译期裁剪；二进制模式下格式串不进镜像，只输出字典ID和原始参数
+#if defined(CONFIG_APP_TAP_LOG_LEVEL)
+#define TAP_LOG_LEVEL CONFIG_APP_TAP_LOG_LEVEL
+#elif !defined(TAP_LOG_LEVEL)
+#define TAP_LOG_LEVEL TAP_LOG_LVL_DBG
+#endif
+
+#if defined(CONFIG_APP_TAP_LOG_BINARY) && !defined(TAP_LOG_BINARY)
+#define TAP_LOG_BINARY
+#endif
+
+static tap_log_rec_cb_t g_rec_cb = NULL;
+static uint32_t g_log_ts;               // 当前样本时间戳，作为记录时间
+
+static inline uint32_t tap_log_arg_f(double v)
+{
+    float f = (float)v;
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline uint32_t tap_log_arg_i(int32_t v)
+{
+    return (uint32_t)v;
+}
+
+#define TAP_LOG_ARG(x) _Generic((x), float: tap_log_arg_f, double: tap_log_arg_f, \
+                                default: tap_log_arg_i)(x)
+#define TAP_LOG_NARGS(...) TAP_LOG_NARGS_(_, ##__VA_ARGS__, 3, 2, 1, 0)
+#define TAP_LOG_NARGS_(_, a, b, c, n, ...) n
+#define TAP_LOG_CAT(a, b) TAP_LOG_CAT_(a, b)
+#define TAP_LOG_CAT_(a, b) a##b
+#define TAP_LOG_PACK(...) TAP_LOG_CAT(TAP_LOG_PACK_, TAP_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define TAP_LOG_PACK_0() 0
+#define TAP_LOG_PACK_1(a) TAP_LOG_ARG(a)
+#define TAP_LOG_PACK_2(a, b) TAP_LOG_ARG(a), TAP_LOG_ARG(b)
+#define TAP_LOG_PACK_3(a, b, c) TAP_LOG_ARG(a), TAP_LOG_ARG(b), TAP_LOG_ARG(c)
+
+static void tap_log_emit(uint16_t id, uint8_t nargs, const uint32_t *args)
+{
+    TapLogRecord rec = { .id = id, .nargs = nargs, .ts = g_log_ts };
+    memcpy(rec.args, args, sizeof(rec.args));
+    g_rec_cb(&rec);
+}
+
+void tap_detector_set_log_sink(tap_log_rec_cb_t cb)
+{
+    g_rec_cb = cb;
+}
+
+#ifdef TAP_LOG_BINARY
+#define TAP_LOG_TEXT(name, ...) do { } while (0)
+
+void tap_detector_set_log(tap_log_cb_t cb)
+{
+    (void)cb;       // 二进制模式不带格式串，文本输出不可用
+}
+#else
+#define TAP_LOG_X_FMT(name, lvl, fmt) fmt,
+static const char *const tap_log_fmt[] = { TAP_LOG_DICT(TAP_LOG_X_FMT) };
+static tap_log_cb_t g_log_cb = NULL;
+
+#define TAP_LOG_TEXT(name, ...) \
+    do { if (g_log_cb) g_log_cb(tap_log_fmt[TAP_LOG_ID_##name], ##__VA_ARGS__); } while (0)
+
+void tap_detector_set_log(tap_log_cb_t cb)
+{
+    g_log_cb = cb;
+}
+#endif
+
+#define TAP_LOG(name, ...) do {                                                 \
+    if (TAP_LOG_LEVEL_OF_##name <= TAP_LOG_LEVEL) {                             \
+        TAP_LOG_TEXT(name, ##__VA_ARGS__);                                      \
+        if (g_rec_cb) {                                                         \
+            const uint32_t _args[TAP_LOG_MAX_ARGS] = { TAP_LOG_PACK(__VA_ARGS__) }; \
+            tap_log_emit(TAP_LOG_ID_##name, TAP_LOG_NARGS(__VA_ARGS__), _args); \
+        }                                                                       \
+    }                                                                           \
+} while (0)
+
+// ===== 单调队列（滑动窗口最值）=====
+static void mdq_init(MonoDeque *q, uint16_t *storage, int cap) {
+    q->pos = storage;
+    q->cap = cap;
+    q->first = 0;
+    q->cnt = 0;
+}
+
+static inline int mdq_front(const MonoDeque *q) {
+    return q->pos[q->first];
+}
+
+static inline int mdq_back(const MonoDeque *q) {
+    int i = q->first + q->cnt - 1;
+    return q->pos[i >= q->cap ? i - q->cap : i];
+}
+
+static inline void mdq_pop_front(MonoDeque *q) {
+    if (++q->first == q->cap) q->first = 0;
+    q->cnt--;
+}
+
+static inline void mdq_pop_back(MonoDeque *q) {
+    q->cnt--;
+}
+
+static inline void mdq_push_back(MonoDeque *q, int pos) {
+    int i = q->first + q->cnt;
+    q->pos[i >= q->cap ? i - q->cap : i] = (uint16_t)pos;
+    q->cnt++;
+}
+
+// 即将被覆盖的位置若在队首则出队
+static inline void mdq_evict(MonoDeque *q, int pos) {
+    if (q->cnt > 0 && mdq_front(q) == pos) mdq_pop_front(q);
+}
+
+// ===== 增量统计窗口 =====
+// 维护滑动和/平方和与最值单调队列，push和统计查询都是O(1)。
+// 窗口大小在运行时由 win_init 指定，存储由调用者提供。
+
+// ===== 平滑窗口操作 =====
+// 窗口按时间跨度 size*SAMPLING_INTERVAL_MS 淘汰旧值，参考采样率下恰好是size个样本，
+// 采样率变化时窗口覆盖的时间不变，切换采样率不必清空窗口
+static inline int smooth_tail(int head, int len) {
+    int i = head - len;
+    return i < 0 ? i + SMOOTH_WIN_MAX : i;
+}
+
+static void smooth_init(SmoothWin *w, float *storage, int64_t *ts, int size) {
+    w->buff = storage;
+    w->ts = ts;
+    w->size = size;
+    w->head = 0;
+    w->len = 0;
+    w->sum = 0.0f;
+}
+
+static void smooth_push(SmoothWin *w, float v, int64_t now) {
+    int64_t span = (int64_t)w->size * SAMPLING_INTERVAL_MS;
+
+    // 跨度以外的旧值出窗；存储满时（采样率过高）也淘汰最旧的
+    while (w->len > 0) {
+        int tail = smooth_tail(w->head, w->len);
+        if (w->len < SMOOTH_WIN_MAX && now - w->ts[tail] < span) break;
+        w->sum -= w->buff[tail];
+        w->len--;
+    }
+    w->buff[w->head] = v;
+    w->ts[w->head] = now;
+    w->sum += v;
+    w->len++;
+    if (++w->head == SMOOTH_WIN_MAX) {
+        w->head = 0;
+        // 每绕一圈重新求和一次，消除浮点累加漂移（均摊O(1)）
+        float sum = 0.0f;
+        for (int k = 0; k < w->len; k++) sum += w->buff[smooth_tail(w->head, w->len - k)];
+        w->sum = sum;
+    }
+}
+
+static float smooth_avg(SmoothWin *w) {
+    if (w->len == 0) return 0.0f;
+    return w->sum / w->len;
+}
+
+// ===== 改进的窗口操作 =====
+static void win_init(FwStaticWin *w, float *storage, uint16_t *minq, uint16_t *maxq, int size) {
+    w->buff = storage;
+    w->size = size;
+    w->head = 0;
+    w->len = 0;
+    w->sum = 0.0f;
+    w->sum_sq = 0.0f;
+    mdq_init(&w->minq, minq, size);
+    mdq_init(&w->maxq, maxq, size);
+}
+
+static void win_push(FwStaticWin *w, float v) {
+    if (w->len == w->size) {
+        float old = w->buff[w->head];
+        w->sum -= old;
+        w->sum_sq -= old * old;
+        mdq_evict(&w->minq, w->head);
+        mdq_evict(&w->maxq, w->head);
+    }
+    w->buff[w->head] = v; 
+    w->sum += v;
+    w->sum_sq += v * v;
+
+    while (w->minq.cnt > 0 && w->buff[mdq_back(&w->minq)] >= v) mdq_pop_back(&w->minq);
+    mdq_push_back(&w->minq, w->head);
+    while (w->maxq.cnt > 0 && w->buff[mdq_back(&w->maxq)] <= v) mdq_pop_back(&w->maxq);
+    mdq_push_back(&w->maxq, w->head);
+
+    if (++w->head == w->size) {
+        w->head = 0;
+        // 每绕一圈重新累加一次，消除浮点漂移（均摊O(1)）
+        if (w->len + 1 >= w->size) {
+            float sum = 0.0f, sum_sq = 0.0f;
+            for (int i = 0; i < w->size; i++) {
+                sum += w->buff[i];
+                sum_sq += w->buff[i] * w->buff[i];
+            }
+            w->sum = sum;
+            w->sum_sq = sum_sq;
+        }
+    }
+    if (w->len < w->size) w->len++;
+}
+
+static void win_stat(FwStaticWin *w, float *mean, float *var, float *minv, float *maxv) {
+    int l = w->len; 
+    *mean = 0; *var = 0; 
+    *maxv = STAT_WIN_INIT_MAX; 
+    *minv = STAT_WIN_INIT_MIN;
+    
+    if (l == 0) return;
+    
+    *mean = w->sum / l;
+    *var = w->sum_sq / l - *mean * *mean;
+    if (*var < 0.0f) *var = 0.0f;
+    *minv = w->buff[mdq_front(&w->minq)];
+    *maxv = w->buff[mdq_front(&w->maxq)];
+}
+
+static float calc_mag(int16_t ax, int16_t ay, int16_t az) {
+    float x = (float)ax / ACCEL_SCALE;
+    float y = (float)ay / ACCEL_SCALE; 
+    float z = (float)az / ACCEL_SCALE;
+    return sqrtf(x*x + y*y + z*z);
+}
+
+// ===== 改进的方向性检测 =====
+static bool is_intentional_tap_direction(const TapParams *p, int16_t ax, int16_t ay, int16_t az) {
+    float x = fabsf((float)ax / ACCEL_SCALE);
+    float y = fabsf((float)ay / ACCEL_SCALE);
+    float z = fabsf((float)az / ACCEL_SCALE);
+    
+    // 找出最大的轴向
+    float max_axis = fmaxf(fmaxf(x, y), z);
+    float sum_other = x + y + z - max_axis;
+    
+    // 改进的方向性检测逻辑
+    bool strong_enough = max_axis > p->axis_dom_min;
+    bool dominant = max_axis > p->axis_dom_ratio * fmaxf(sum_other, 0.01f);
+    
+    return strong_enough && dominant;
+}
+
+// ===== 自校准功能 =====
+static void update_calibration(CalibrationState *cal, float acc_g, bool is_static) {
+    if (!is_static) return;
+    
+    if (cal->sample_count < CALIBRATION_SAMPLES) {
+        cal->sum += acc_g;
+        cal->sample_count++;
+        
+        if (cal->sample_count == CALIBRATION_SAMPLES) {
+            float new_ref = cal->sum / CALIBRATION_SAMPLES;
+            // 只有在合理范围内才更新参考值
+            if (fabsf(new_ref - GRAVITY_NOMINAL) < 0.3f) {
+                cal->gravity_ref = new_ref;
+                cal->calibrated = true;
+                TAP_LOG(CAL_DONE, cal->gravity_ref);
+            } else {
+                TAP_LOG(CAL_REJECT, new_ref);
+                cal->sample_count = 0;
+                cal->sum = 0.0f;
+            }
+        }
+    }
+}
+
+static float get_gravity_reference(CalibrationState *cal) {
+    return cal->calibrated ? cal->gravity_ref : GRAVITY_NOMINAL;
+}
+
+// ===== 改进的姿态稳定性检测 =====
+static bool is_posture_stable(const TapParams *p, FwStaticWin *win, float gravity_ref) {
+    float mean, var, minv, maxv;
+    win_stat(win, &mean, &var, &minv, &maxv);
+    
+    if (win->len < win->size) return false;
+    
+    // 使用自校准的重力参考值
+    bool low_variance = (var < p->static_var_th);
+    bool small_range = (maxv - minv < p->static_diff_th);
+    bool near_gravity = (fabsf(mean - gravity_ref) < p->posture_stable_th);
+    
+    return low_variance && small_range && near_gravity;
+}
+
+// ===== 旋转伪敲击检测（两种检测器共用，全整数）=====
+static void attitude_tap_start(TapAttitude *att)
+{
+    memcpy(att->start_grav, att->grav, sizeof(att->start_grav));
+    att->peak_rate = att->rate_dps;
+}
+
+static void attitude_tap_track(TapAttitude *att)
+{
+    att->peak_rate = MAX(att->peak_rate, att->rate_dps);
+}
+
+// 敲击期间转速过快或前后姿态变化过大，说明模长突变来自手腕转动而非敲击
+static bool is_rotation_artifact(const TapAttitude *att, int32_t *tilt_cos_x1000)
+{
+    if (!att->valid) return false;
+
+    int64_t dot = (int64_t)att->grav[0] * att->start_grav[0] +
+                  (int64_t)att->grav[1] * att->start_grav[1] +
+                  (int64_t)att->grav[2] * att->start_grav[2];
+    *tilt_cos_x1000 = (int32_t)(dot * 1000 / ((int64_t)ACCEL_SCALE * (int64_t)ACCEL_SCALE));
+    return att->peak_rate > ROT_RATE_REJECT_DPS || *tilt_cos_x1000 < ROT_TILT_COS_X1000;
+}
+
+static void attitude_set(TapAttitude *att, const int16_t grav[3], int32_t rate_dps)
+{
+    memcpy(att->grav, grav, sizeof(att->grav));
+    att->rate_dps = rate_dps;
+    att->valid = true;
+}
+
+// ===== 手势分类（两种检测器共用，全整数）=====
+typedef enum { GESTURE_KIND_NONE, GESTURE_KIND_TAPS, GESTURE_KIND_SHAKE, GESTURE_KIND_HOLD } gesture_kind_t;
+
+static const struct {
+    uint8_t kind;
+    uint8_t taps;
+} gesture_kind_tab[GESTURE_NUM] = {
+    [GESTURE_SINGLE_TAP] = { GESTURE_KIND_TAPS, 1 },
+    [GESTURE_DOUBLE_TAP] = { GESTURE_KIND_TAPS, 2 },
+    [GESTURE_TRIPLE_TAP] = { GESTURE_KIND_TAPS, 3 },
+    [GESTURE_SHAKE]      = { GESTURE_KIND_SHAKE, 0 },
+    [GESTURE_HOLD_STILL] = { GESTURE_KIND_HOLD, 0 },
+};
+
+#define TAP_GESTURE_PARAMS {                                    \
+    .enabled = true,                                            \
+    .gap_min_ms = DOUBLE_TAP_MIN_MS,                            \
+    .gap_max_ms = DOUBLE_TAP_MAX_MS,                            \
+    .consist_x10 = TAP_CONSISTENCY_X10,                         \
+    .cooldown_ms = DOUBLE_TAP_COOLDOWN,                         \
+}
+
+const GestureParams gesture_default_params[GESTURE_NUM] = {
+    [GESTURE_SINGLE_TAP] = { .enabled = true },
+    [GESTURE_DOUBLE_TAP] = TAP_GESTURE_PARAMS,
+    [GESTURE_TRIPLE_TAP] = TAP_GESTURE_PARAMS,
+    [GESTURE_SHAKE] = {
+        .enabled = true,
+        .th_mg = SHAKE_TH_MG,
+        .count = SHAKE_COUNT,
+        .window_ms = SHAKE_WINDOW_MS,
+        .cooldown_ms = SHAKE_WINDOW_MS,
+    },
+    [GESTURE_HOLD_STILL] = { .enabled = true, .window_ms = HOLD_STILL_MS },
+};
+
+static int gesture_load(GestureClassifier *gc, const GestureParams params[GESTURE_NUM])
+{
+    for (int g = 1; g < GESTURE_NUM; g++) {
+        const GestureParams *p = &params[g];
+
+        if (!p->enabled) continue;
+        if (gesture_kind_tab[g].kind == GESTURE_KIND_TAPS && gesture_kind_tab[g].taps > 1 &&
+            (p->gap_max_ms == 0 || p->gap_min_ms > p->gap_max_ms)) {
+            return -EINVAL;
+        }
+        if (gesture_kind_tab[g].kind == GESTURE_KIND_SHAKE &&
+            (p->th_mg == 0 || p->count == 0 || p->window_ms == 0)) {
+            return -EINVAL;
+        }
+    }
+
+    memcpy(gc->params, params, sizeof(gc->params));
+    gc->params[GESTURE_NONE].enabled = false;
+    memset(gc->tap_gesture, GESTURE_NONE, sizeof(gc->tap_gesture));
+    for (int g = 1; g < GESTURE_NUM; g++) {
+        if (gc->params[g].enabled && gesture_kind_tab[g].kind == GESTURE_KIND_TAPS) {
+            gc->tap_gesture[gesture_kind_tab[g].taps] = g;
+        }
+    }
+
+    // 展开连击序列规则：第k次敲击按"至少k次"里次数最少的已启用手势判定间隔，
+    // 分类时只查表，不随手势数量循环
+    gc->max_taps = 0;
+    for (int k = GESTURE_TAPS_MAX; k >= 1; k--) {
+        gesture_t g = gc->tap_gesture[k];
+        if (g == GESTURE_NONE) {
+            if (k >= 2 && gc->max_taps) {
+                gc->seq_gap_min[k] = gc->seq_gap_min[k + 1];
+                gc->seq_gap_max[k] = gc->seq_gap_max[k + 1];
+                gc->seq_consist[k] = gc->seq_consist[k + 1];
+            }
+            continue;
+        }
+        if (!gc->max_taps) gc->max_taps = k;
+        if (k >= 2) {
+            gc->seq_gap_min[k] = gc->params[g].gap_min_ms;
+            gc->seq_gap_max[k] = gc->params[g].gap_max_ms;
+            gc->seq_consist[k] = gc->params[g].consist_x10;
+        }
+    }
+    gc->taps = 0;
+    gc->shake_count = 0;
+    gc->shake_above = false;
+    gc->still_since = -1;
+    gc->still_reported = false;
+    return 0;
+}
+
+static void gesture_push(GestureClassifier *gc, gesture_t type, int taps, int64_t ts, int64_t now)
+{
+    const GestureParams *p = &gc->params[type];
+
+    if (gc->last_evt_ts[type] && now - gc->last_evt_ts[type] <= p->cooldown_ms) {
+        TAP_LOG(GESTURE_CD, (int32_t)type);
+        return;
+    }
+    gc->last_evt_ts[type] = now;
+    TAP_LOG(GESTURE, (int32_t)type, (int32_t)taps,
+            (int32_t)(taps > 1 ? gc->last_tap_ts - gc->first_tap_ts : 0));
+    if (gc->q_len < GESTURE_QUEUE_LEN) {
+        gc->queue[(gc->q_head + gc->q_len) % GESTURE_QUEUE_LEN] =
+            (GestureEvent){ .type = type, .taps = (uint8_t)taps, .ts = ts };
+        gc->q_len++;
+    }
+}
+
+static void gesture_seq_start(GestureClassifier *gc, int64_t now, int32_t mag_mg)
+{
+    gc->taps = 1;
+    gc->first_tap_ts = now;
+    gc->last_tap_ts = now;
+    gc->first_tap_mg = mag_mg;
+}
+
+// 序列已是最大次数，或下一次敲击的间隔已超时：按当前次数确认。
+// 运动唤醒补记的第一次（幅度为0）只给连击做铺垫，后面没有真实敲击时不单独确认
+static void gesture_seq_close(GestureClassifier *gc, int64_t now)
+{
+    gesture_t g = gc->tap_gesture[gc->taps];
+
+    if (gc->taps == 1 && gc->first_tap_mg == 0) {
+        TAP_LOG(DT_TIMEOUT);
+    } else if (g != GESTURE_NONE) {
+        gesture_push(gc, g, gc->taps, gc->last_tap_ts, now);
+    } else {
+        TAP_LOG(DT_TIMEOUT);
+    }
+    gc->taps = 0;
+}
+
+// 本次敲击能否接在当前序列后面：间隔和幅度一致性按序列下一次的规则判定
+static bool gesture_tap_continues(const GestureClassifier *gc, int64_t now, int32_t mag_mg)
+{
+    int next = gc->taps + 1;
+    int64_t dt = now - gc->last_tap_ts;
+    int32_t lo = MIN(gc->first_tap_mg, mag_mg);
+    int32_t hi = MAX(gc->first_tap_mg, mag_mg);
+
+    if (dt < gc->seq_gap_min[next] || dt > gc->seq_gap_max[next]) {
+        TAP_LOG(DT_RANGE, (int32_t)dt);
+        return false;
+    }
+    // 运动唤醒补记的第一次敲击幅度为0，不检查
+    if (gc->first_tap_mg != 0 && gc->seq_consist[next] &&
+        (lo <= 0 || (int64_t)hi * 10 >= (int64_t)lo * gc->seq_consist[next])) {
+        TAP_LOG(INCONSISTENT_Q, gc->first_tap_mg, mag_mg);
+        return false;
+    }
+    TAP_LOG(TAP_N_Q, next, (int32_t)dt, mag_mg);
+    return true;
+}
+
+// 一次已确认（并通过旋转抑制）的敲击
+static void gesture_tap(GestureClassifier *gc, int64_t now, int32_t mag_mg)
+{
+    if (!gc->max_taps) return;
+
+    if (gc->taps == 0) {
+        gesture_seq_start(gc, now, mag_mg);
+        TAP_LOG(FIRST_TAP_Q, mag_mg);
+    } else if (gesture_tap_continues(gc, now, mag_mg)) {
+        gc->taps++;
+        gc->last_tap_ts = now;
+    } else {
+        // 间隔或幅度不符：本次敲击作为新序列的第一次
+        gesture_seq_start(gc, now, mag_mg);
+        TAP_LOG(RESET_FIRST);
+    }
+    if (gc->taps < gc->max_taps) return;
+
+    // 已是最大次数，不必等间隔超时；冷却中则本次敲击作为新序列的第一次
+    gesture_t g = gc->tap_gesture[gc->taps];
+    if (gc->last_evt_ts[g] && now - gc->last_evt_ts[g] <= gc->params[g].cooldown_ms) {
+        TAP_LOG(GESTURE_CD, (int32_t)g);
+        if (gc->max_taps > 1) {
+            gesture_seq_start(gc, now, mag_mg);
+            TAP_LOG(RESET_FIRST);
+        } else {
+            gc->taps = 0;
+        }
+        return;
+    }
+    gesture_seq_close(gc, now);
+}
+
+// 每样本一次：连击超时、晃动计数、静止计时
+static void gesture_step(GestureClassifier *gc, int64_t now, int32_t dev_mg, bool still)
+{
+    if (gc->taps && now - gc->last_tap_ts > gc->seq_gap_max[gc->taps + 1]) {
+        gesture_seq_close(gc, now);
+    }
+
+    const GestureParams *shake = &gc->params[GESTURE_SHAKE];
+    if (shake->enabled) {
+        if (!gc->shake_above && dev_mg > shake->th_mg) {
+            gc->shake_above = true;
+            if (gc->shake_count == 0 || now - gc->shake_start_ts > shake->window_ms) {
+                gc->shake_count = 0;
+                gc->shake_start_ts = now;
+            }
+            if (++gc->shake_count >= shake->count) {
+                gc->shake_count = 0;
+                gc->taps = 0;           // 晃动期间的"敲击"不算连击
+                gesture_push(gc, GESTURE_SHAKE, 0, now, now);
+            }
+        } else if (gc->shake_above && dev_mg < shake->th_mg / 2) {
+            gc->shake_above = false;    // 回落到一半以下才算下一次，避免在阈值附近抖动
+        }
+    }
+
+    const GestureParams *hold = &gc->params[GESTURE_HOLD_STILL];
+    if (!still) {
+        gc->still_since = -1;
+        gc->still_reported = false;
+    } else if (gc->still_since < 0) {
+        gc->still_since = now;
+    } else if (hold->enabled && !gc->still_reported && now - gc->still_since >= hold->window_ms) {
+        gc->still_reported = true;
+        gesture_push(gc, GESTURE_HOLD_STILL, 0, now, now);
+    }
+}
+
+static gesture_t gesture_pop(GestureClassifier *gc)
+{
+    if (gc->q_len == 0) return GESTURE_NONE;
+    gc->last = gc->queue[gc->q_head];
+    gc->q_head = (gc->q_head + 1) % GESTURE_QUEUE_LEN;
+    gc->q_len--;
+    return gc->last.type;
+}
+
+// 唤醒只为连击补记第一次敲击，没有启用多击手势时不补
+static void gesture_wake(GestureClassifier *gc, int64_t ts)
+{
+    if (gc->max_taps < 2) return;
+    gesture_seq_start(gc, ts, 0);
+    TAP_LOG(WAKE_FIRST);
+}
+
+// still_since 每样本由 gesture_step 按姿态稳定更新
+static bool gesture_idle(const GestureClassifier *gc, bool tap_in_progress)
+{
+    return !tap_in_progress && gc->taps == 0 && gc->still_since >= 0;
+}
+
+// 静止窗口按参考周期抽样：采样率高于参考时每个参考周期只进一个样本，
+// 窗口覆盖的时间和方差阈值不随采样率变化。
+// 抽样时刻按参考周期推进而不是取当前样本时间，否则高采样率下每 WIN_STEP_MIN_MS
+// 就进一个样本，窗口覆盖的时间变短；落后超过一个周期（断流、低采样率）才重新对齐
+static bool win_due(bool *started, int64_t *win_ts, int64_t now)
+{
+    if (*started && now - *win_ts < WIN_STEP_MIN_MS) return false;
+    if (*started) {
+        *win_ts += SAMPLING_INTERVAL_MS;
+    }
+    if (!*started || now - *win_ts >= SAMPLING_INTERVAL_MS) {
+        *win_ts = now;
+    }
+    *started = true;
+    return true;
+}
+
+// ===== 改进的敲击检测器：确认的敲击和每样本特征交给手势分类 =====
+// win_step: 本样本是否进了静止窗口（按参考周期抽样），自校准随之抽样
+static void detect_tap_ring(const TapParams *p,
+                            int16_t ax, int16_t ay, int16_t az,
+                            float acc_g, int64_t now, bool win_step,
+                            FwStaticWin *stat_win,
+                            DoubleTapState *st,
+                            CalibrationState *cal)
+{
+    float gravity_ref = get_gravity_reference(cal);
+    
+    // 平滑处理
+    smooth_push(&st->smooth_win, acc_g, now);
+    float smooth_acc = smooth_avg(&st->smooth_win);
+    
+    // 检查基本条件
+    bool posture_stable = is_posture_stable(p, stat_win, gravity_ref);
+    bool near_gravity = fabsf(smooth_acc - gravity_ref) < p->gravity_tol;
+    bool good_direction = is_intentional_tap_direction(p, ax, ay, az);
+    
+    // 更新自校准
+    update_calibration(cal, smooth_acc, win_step && posture_stable && near_gravity);
+
+    // 晃动、静止和连击超时只依赖这两个特征，不论环境是否稳定都要更新
+    gesture_step(&st->gc, now, (int32_t)(fabsf(smooth_acc - gravity_ref) * 1000.0f),
+                 posture_stable);
+    
+    // 基本环境检查 - 放宽条件
+    if (!posture_stable && !near_gravity) {
+        // 环境不稳定，但不立即重置状态，给一定容忍度
+        if (!st->tap_in_progress) {
+            return;
+        }
+    }
+    
+    // 使用平滑后的突变检测，采样间隔短于参考周期时按比例放大到参考周期；
+    // 长于参考周期时不缩小，短促的冲击在低采样率下不会被摊薄
+    float acc_spike = smooth_acc - st->last_smooth_acc;
+    int64_t dt = now - st->last_ts;
+    if (dt > 0 && dt < SAMPLING_INTERVAL_MS) {
+        acc_spike = acc_spike * (float)SAMPLING_INTERVAL_MS / (float)dt;
+    }
+    
+    // 检测敲击开始
+    if (!st->tap_in_progress && acc_spike > p->spike_th && smooth_acc > p->peak_abs_th &&
+        now >= st->cd_until) {
+        if (good_direction || near_gravity) { // 降低方向性要求
+            st->tap_in_progress = true;
+            st->tap_start_ts = now;
+            attitude_tap_start(&st->att);
+            TAP_LOG(TAP_START, smooth_acc, acc_spike);
+        }
+    }
+    
+    // 检测敲击结束并确认
+    if (st->tap_in_progress) {
+        int64_t tap_duration = now - st->tap_start_ts;
+        int32_t tilt_cos;
+        attitude_tap_track(&st->att);
+        
+        // 敲击持续时间足够长且现在回落
+        if (tap_duration >= p->min_duration_ms && acc_spike < -p->spike_th * 0.4f) {
+            st->tap_in_progress = false;
+            st->cd_until = now + p->cooldown_ms;
+            
+            TAP_LOG(TAP_END, (int32_t)tap_duration);
+            
+            // 确认这是一次有效敲击，连击判定交给手势分类
+            if (is_rotation_artifact(&st->att, &tilt_cos)) {
+                // 转腕造成的模长突变，不计入连击，也不打断进行中的序列
+                TAP_LOG(ROT_REJECT, st->att.peak_rate, tilt_cos);
+            } else {
+                gesture_tap(&st->gc, now, (int32_t)(smooth_acc * 1000.0f));
+            }
+        }
+        // 敲击超时
+        else if (tap_duration > p->min_duration_ms * 4) {
+            st->tap_in_progress = false;
+            TAP_LOG(TAP_TIMEOUT, (int32_t)tap_duration);
+        }
+    }
+    
+    st->last_smooth_acc = smooth_acc;
+    st->last_ts = now;
+}
+
+// ===== 定点双击检测 =====
+// 直接在原始int16计数上运算（1g = ACCEL_SCALE），默认阈值编译期换算成计数，热路径不碰FPU。
+#define ACCEL_Q(g)          ((int32_t)((g) * ACCEL_SCALE + 0.5f))                  // g -> 计数
+#define ACCEL_Q2(g2)        ((int64_t)((g2) * ACCEL_SCALE * ACCEL_SCALE + 0.5f))   // g^2 -> 计数^2
+#define RATIO_Q16(r)        ((int64_t)((r) * 65536.0f + 0.5f))
+
+#define AXIS_DOM_FLOOR_Q    ACCEL_Q(0.01f)
+#define GRAVITY_NOMINAL_Q   ACCEL_Q(GRAVITY_NOMINAL)
+#define CALIB_RANGE_Q       ACCEL_Q(0.3f)
+
+static void smooth_init_q(SmoothWinQ *w, int32_t *storage, int64_t *ts, int size) {
+    w->buff = storage;
+    w->ts = ts;
+    w->size = size;
+    w->head = 0;
+    w->len = 0;
+    w->sum = 0;
+}
+
+static void smooth_push_q(SmoothWinQ *w, int32_t v, int64_t now) {
+    int64_t span = (int64_t)w->size * SAMPLING_INTERVAL_MS;
+
+    while (w->len > 0) {
+        int tail = smooth_tail(w->head, w->len);
+        if (w->len < SMOOTH_WIN_MAX && now - w->ts[tail] < span) break;
+        w->sum -= w->buff[tail];
+        w->len--;
+    }
+    w->buff[w->head] = v;
+    w->ts[w->head] = now;
+    w->sum += v;
+    w->len++;
+    if (++w->head == SMOOTH_WIN_MAX) w->head = 0;
+}
+
+static int32_t smooth_avg_q(SmoothWinQ *w) {
+    if (w->len == 0) return 0;
+    return w->sum / w->len;
+}
+
+static void win_init_q(FwStaticWinQ *w, int32_t *storage, uint16_t *minq, uint16_t *maxq, int size) {
+    w->buff = storage;
+    w->size = size;
+    w->head = 0;
+    w->len = 0;
+    w->sum = 0;
+    w->sum_sq = 0;
+    mdq_init(&w->minq, minq, size);
+    mdq_init(&w->maxq, maxq, size);
+}
+
+static void win_push_q(FwStaticWinQ *w, int32_t v) {
+    if (w->len == w->size) {
+        int32_t old = w->buff[w->head];
+        w->sum -= old;
+        w->sum_sq -= (int64_t)old * old;
+        mdq_evict(&w->minq, w->head);
+        mdq_evict(&w->maxq, w->head);
+    }
+    w->buff[w->head] = v;
+    w->sum += v;
+    w->sum_sq += (int64_t)v * v;
+
+    while (w->minq.cnt > 0 && w->buff[mdq_back(&w->minq)] >= v) mdq_pop_back(&w->minq);
+    mdq_push_back(&w->minq, w->head);
+    while (w->maxq.cnt > 0 && w->buff[mdq_back(&w->maxq)] <= v) mdq_pop_back(&w->maxq);
+    mdq_push_back(&w->maxq, w->head);
+
+    if (++w->head == w->size) w->head = 0;
+    if (w->len < w->size) w->len++;
+}
+
+// var = (l*Σv² - (Σv)²) / l²，窗口上限256个样本时不会溢出int64
+static void win_stat_q(FwStaticWinQ *w, int32_t *mean, int64_t *var, int32_t *minv, int32_t *maxv) {
+    int l = w->len;
+    *var = 0;
+    *maxv = INT32_MIN;
+    *minv = INT32_MAX;
+    *mean = 0;
+
+    if (l == 0) return;
+
+    *mean = w->sum / l;
+    *var = ((int64_t)l * w->sum_sq - (int64_t)w->sum * w->sum) / ((int64_t)l * l);
+    *minv = w->buff[mdq_front(&w->minq)];
+    *maxv = w->buff[mdq_front(&w->maxq)];
+}
+
+static bool is_intentional_tap_direction_q(const TapParamsQ *p, int16_t ax, int16_t ay, int16_t az) {
+    int32_t x = ax < 0 ? -(int32_t)ax : ax;
+    int32_t y = ay < 0 ? -(int32_t)ay : ay;
+    int32_t z = az < 0 ? -(int32_t)az : az;
+
+    int32_t max_axis = MAX(MAX(x, y), z);
+    int32_t sum_other = x + y + z - max_axis;
+
+    bool strong_enough = max_axis > p->axis_dom_min;
+    bool dominant = (int64_t)max_axis * 65536 >
+                    p->axis_dom_ratio_q16 * MAX(sum_other, AXIS_DOM_FLOOR_Q);
+
+    return strong_enough && dominant;
+}
+
+static void update_calibration_q(CalibrationStateQ *cal, int32_t acc, bool is_static) {
+    if (!is_static) return;
+
+    if (cal->sample_count < CALIBRATION_SAMPLES) {
+        cal->sum += acc;
+        cal->sample_count++;
+
+        if (cal->sample_count == CALIBRATION_SAMPLES) {
+            int32_t new_ref = cal->sum / CALIBRATION_SAMPLES;
+            int32_t dev = new_ref - GRAVITY_NOMINAL_Q;
+            if ((dev < 0 ? -dev : dev) < CALIB_RANGE_Q) {
+                cal->gravity_ref = new_ref;
+                cal->calibrated = true;
+                TAP_LOG(CAL_DONE_Q, ACCEL_COUNTS_TO_MG(cal->gravity_ref));
+            } else {
+                TAP_LOG(CAL_REJECT_Q, ACCEL_COUNTS_TO_MG(new_ref));
+                cal->sample_count = 0;
+                cal->sum = 0;
+            }
+        }
+    }
+}
+
+static int32_t get_gravity_reference_q(CalibrationStateQ *cal) {
+    return cal->calibrated ? cal->gravity_ref : GRAVITY_NOMINAL_Q;
+}
+
+static bool is_posture_stable_q(const TapParamsQ *p, FwStaticWinQ *win, int32_t gravity_ref) {
+    int32_t mean, minv, maxv;
+    int64_t var;
+    win_stat_q(win, &mean, &var, &minv, &maxv);
+
+    if (win->len < win->size) return false;
+
+    int32_t dev = mean - gravity_ref;
+    bool low_variance = (var < p->static_var);
+    bool small_range = (maxv - minv < p->static_diff);
+    bool near_gravity = ((dev < 0 ? -dev : dev) < p->posture_stable);
+
+    return low_variance && small_range && near_gravity;
+}
+
+static void detect_tap_ring_q(const TapParamsQ *p,
+                              int16_t ax, int16_t ay, int16_t az,
+                              int32_t smooth_acc, int64_t now, bool win_step,
+                              FwStaticWinQ *stat_win,
+                              DoubleTapStateQ *st,
+                              CalibrationStateQ *cal)
+{
+    int32_t gravity_ref = get_gravity_reference_q(cal);
+
+    int32_t dev = smooth_acc - gravity_ref;
+    bool posture_stable = is_posture_stable_q(p, stat_win, gravity_ref);
+    bool near_gravity = (dev < 0 ? -dev : dev) < p->gravity_tol;
+    bool good_direction = is_intentional_tap_direction_q(p, ax, ay, az);
+
+    update_calibration_q(cal, smooth_acc, win_step && posture_stable && near_gravity);
+
+    gesture_step(&st->gc, now, ACCEL_COUNTS_TO_MG(dev < 0 ? -dev : dev), posture_stable);
+
+    if (!posture_stable && !near_gravity) {
+        if (!st->tap_in_progress) {
+            return;
+        }
+    }
+
+    int32_t acc_spike = smooth_acc - st->last_smooth_acc;
+    int64_t dt = now - st->last_ts;
+    if (dt > 0 && dt < SAMPLING_INTERVAL_MS) {
+        acc_spike = (int32_t)((int64_t)acc_spike * SAMPLING_INTERVAL_MS / dt);
+    }
+
+    if (!st->tap_in_progress && acc_spike > p->spike && smooth_acc > p->peak_abs &&
+        now >= st->cd_until) {
+        if (good_direction || near_gravity) {
+            st->tap_in_progress = true;
+            st->tap_start_ts = now;
+            attitude_tap_start(&st->att);
+            TAP_LOG(TAP_START_Q, ACCEL_COUNTS_TO_MG(smooth_acc), ACCEL_COUNTS_TO_MG(acc_spike));
+        }
+    }
+
+    if (st->tap_in_progress) {
+        int64_t tap_duration = now - st->tap_start_ts;
+        int32_t tilt_cos;
+        attitude_tap_track(&st->att);
+
+        if (tap_duration >= p->min_duration_ms && acc_spike < -p->release) {
+            st->tap_in_progress = false;
+            st->cd_until = now + p->cooldown_ms;
+
+            TAP_LOG(TAP_END, (int32_t)tap_duration);
+
+            if (is_rotation_artifact(&st->att, &tilt_cos)) {
+                TAP_LOG(ROT_REJECT, st->att.peak_rate, tilt_cos);
+            } else {
+                gesture_tap(&st->gc, now, ACCEL_COUNTS_TO_MG(smooth_acc));
+            }
+        }
+        else if (tap_duration > p->min_duration_ms * 4) {
+            st->tap_in_progress = false;
+            TAP_LOG(TAP_TIMEOUT, (int32_t)tap_duration);
+        }
+    }
+
+    st->last_smooth_acc = smooth_acc;
+    st->last_ts = now;
+}
+
+// ===== 对外接口 =====
+int tap_detector_set_windows(TapDetector *det, int static_n, int smooth_n)
+{
+    if (static_n < 1 || static_n > STATIC_WIN_MAX ||
+        smooth_n < 1 || smooth_n > SMOOTH_WIN_MAX) {
+        return -EINVAL;
+    }
+    win_init(&det->static_win, det->static_buf, det->static_minq, det->static_maxq, static_n);
+    smooth_init(&det->st.smooth_win, det->smooth_buf, det->smooth_ts, smooth_n);
+    det->win_started = false;
+    return 0;
+}
+
+const TapParams tap_params_default = {
+    .spike_th = TAP_SPIKE_TH,
+    .peak_abs_th = TAP_PEAK_ABS_TH,
+    .min_duration_ms = TAP_MIN_DURATION_MS,
+    .cooldown_ms = TAP_COOLDOWN_MS,
+    .static_var_th = STATIC_VAR_TH,
+    .static_diff_th = STATIC_DIFF_TH,
+    .gravity_tol = GRAVITY_TOLERANCE,
+    .posture_stable_th = POSTURE_STABLE_TH,
+    .axis_dom_min = AXIS_DOMINANCE_MIN,
+    .axis_dom_ratio = AXIS_DOMINANCE_RATIO,
+};
+
+void tap_detector_set_params(TapDetector *det, const TapParams *p)
+{
+    det->p = *p;
+}
+
+int tap_detector_init(TapDetector *det, int static_n, int smooth_n)
+{
+    memset(det, 0, sizeof(*det));
+    det->cal.gravity_ref = GRAVITY_NOMINAL;
+    det->p = tap_params_default;
+    gesture_load(&det->st.gc, gesture_default_params);
+    return tap_detector_set_windows(det, static_n, smooth_n);
+}
+
+int tap_detector_set_gestures(TapDetector *det, const GestureParams params[GESTURE_NUM])
+{
+    return gesture_load(&det->st.gc, params);
+}
+
+gesture_t tap_detector_process(TapDetector *det, const AccelSample *s)
+{
+    float acc_g = calc_mag(s->ax, s->ay, s->az);
+    g_log_ts = (uint32_t)s->ts;
+    det->last_acc = acc_g;
+    bool win_step = win_due(&det->win_started, &det->win_ts, s->ts);
+    if (win_step) win_push(&det->static_win, acc_g);
+    detect_tap_ring(&det->p, s->ax, s->ay, s->az, acc_g, s->ts, win_step,
+                    &det->static_win, &det->st, &det->cal);
+    return gesture_pop(&det->st.gc);
+}
+
+void tap_detector_wake(TapDetector *det, int64_t ts)
+{
+    g_log_ts = (uint32_t)ts;
+    det->st.tap_in_progress = false;
+    gesture_wake(&det->st.gc, ts);
+}
+
+void tap_detector_set_attitude(TapDetector *det, const int16_t grav[3], int32_t rate_dps)
+{
+    attitude_set(&det->st.att, grav, rate_dps);
+}
+
+float tap_detector_gravity_ref(const TapDetector *det)
+{
+    return det->cal.calibrated ? det->cal.gravity_ref : GRAVITY_NOMINAL;
+}
+
+bool tap_detector_idle(const TapDetector *det)
+{
+    return gesture_idle(&det->st.gc, det->st.tap_in_progress);
+}
+
+int tap_detector_q_set_windows(TapDetectorQ *det, int static_n, int smooth_n)
+{
+    if (static_n < 1 || static_n > STATIC_WIN_MAX ||
+        smooth_n < 1 || smooth_n > SMOOTH_WIN_MAX) {
+        return -EINVAL;
+    }
+    win_init_q(&det->static_win, det->static_buf, det->static_minq, det->static_maxq, static_n);
+    smooth_init_q(&det->st.smooth_win, det->smooth_buf, det->smooth_ts, smooth_n);
+    det->win_started = false;
+    return 0;
+}
+
+// 默认阈值在编译期换算成计数，定点镜像里不做浮点运算
+const TapParamsQ tap_params_q_default = {
+    .spike = ACCEL_Q(TAP_SPIKE_TH),
+    .release = ACCEL_Q(TAP_SPIKE_TH * 0.4f),
+    .peak_abs = ACCEL_Q(TAP_PEAK_ABS_TH),
+    .static_var = ACCEL_Q2(STATIC_VAR_TH),
+    .static_diff = ACCEL_Q(STATIC_DIFF_TH),
+    .gravity_tol = ACCEL_Q(GRAVITY_TOLERANCE),
+    .posture_stable = ACCEL_Q(POSTURE_STABLE_TH),
+    .axis_dom_min = ACCEL_Q(AXIS_DOMINANCE_MIN),
+    .axis_dom_ratio_q16 = RATIO_Q16(AXIS_DOMINANCE_RATIO),
+    .min_duration_ms = TAP_MIN_DURATION_MS,
+    .cooldown_ms = TAP_COOLDOWN_MS,
+};
+
+// 运行时参数（tap_tune 扫描等）在这里换算，换算规则与 tap_params_q_default 相同
+void tap_params_to_q(const TapParams *p, TapParamsQ *out)
+{
+    *out = (TapParamsQ){
+        .spike = ACCEL_Q(p->spike_th),
+        .release = ACCEL_Q(p->spike_th * 0.4f),
+        .peak_abs = ACCEL_Q(p->peak_abs_th),
+        .static_var = ACCEL_Q2(p->static_var_th),
+        .static_diff = ACCEL_Q(p->static_diff_th),
+        .gravity_tol = ACCEL_Q(p->gravity_tol),
+        .posture_stable = ACCEL_Q(p->posture_stable_th),
+        .axis_dom_min = ACCEL_Q(p->axis_dom_min),
+        .axis_dom_ratio_q16 = RATIO_Q16(p->axis_dom_ratio),
+        .min_duration_ms = p->min_duration_ms,
+        .cooldown_ms = p->cooldown_ms,
+    };
+}
+
+void tap_detector_q_set_params(TapDetectorQ *det, const TapParamsQ *p)
+{
+    det->p = *p;
+}
+
+int tap_detector_q_init(TapDetectorQ *det, int static_n, int smooth_n)
+{
+    memset(det, 0, sizeof(*det));
+    det->cal.gravity_ref = GRAVITY_NOMINAL_Q;
+    det->p = tap_params_q_default;
+    gesture_load(&det->st.gc, gesture_default_params);
+    return tap_detector_q_set_windows(det, static_n, smooth_n);
+}
+
+int tap_detector_q_set_gestures(TapDetectorQ *det, const GestureParams params[GESTURE_NUM])
+{
+    return gesture_load(&det->st.gc, params);
+}
+
+// 平滑窗口只依赖模长和时间戳，可以整批先推进，逐样本判定时直接取平滑值
+void tap_detector_q_prepare(TapDetectorQ *det, const AccelSample *s, size_t stride, int n,
+                            int32_t *mag, int32_t *smooth)
+{
+    accel_block_mag(&s->ax, stride, n, det->last_acc, mag);
+    for (int i = 0; i < n; i++) {
+        const AccelSample *si = (const AccelSample *)((const uint8_t *)s + (size_t)i * stride);
+        smooth_push_q(&det->st.smooth_win, mag[i], si->ts);
+        smooth[i] = smooth_avg_q(&det->st.smooth_win);
+    }
+}
+
+gesture_t tap_detector_q_process_prepared(TapDetectorQ *det, const AccelSample *s,
+                                          int32_t mag, int32_t smooth)
+{
+    g_log_ts = (uint32_t)s->ts;
+    det->last_acc = mag;
+    bool win_step = win_due(&det->win_started, &det->win_ts, s->ts);
+    if (win_step) win_push_q(&det->static_win, mag);
+    detect_tap_ring_q(&det->p, s->ax, s->ay, s->az, smooth, s->ts, win_step,
+                      &det->static_win, &det->st, &det->cal);
+    return gesture_pop(&det->st.gc);
+}
+
+gesture_t tap_detector_q_process(TapDetectorQ *det, const AccelSample *s)
+{
+    int32_t mag, smooth;
+
+    tap_detector_q_prepare(det, s, sizeof(*s), 1, &mag, &smooth);
+    return tap_detector_q_process_prepared(det, s, mag, smooth);
+}
+
+void tap_detector_q_wake(TapDetectorQ *det, int64_t ts)
+{
+    g_log_ts = (uint32_t)ts;
+    det->st.tap_in_progress = false;
+    gesture_wake(&det->st.gc, ts);
+}
+
+void tap_detector_q_set_attitude(TapDetectorQ *det, const int16_t grav[3], int32_t rate_dps)
+{
+    attitude_set(&det->st.att, grav, rate_dps);
+}
+
+int32_t tap_detector_q_gravity_ref(const TapDetectorQ *det)
+{
+    return det->cal.calibrated ? det->cal.gravity_ref : GRAVITY_NOMINAL_Q;
+}
+
+bool tap_detector_q_idle(const TapDetectorQ *det)
+{
+    return gesture_idle(&det->st.gc, det->st.tap_in_progress);
+}
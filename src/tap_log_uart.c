@@ -0,0 +1,39 @@
+#include "tap_log.h"
+#include "spsc_ring.h"
+#include <zephyr/kernel.h>
+
+// 检测器二进制日志的固件后端。
+// 检测线程只把记录放进队列，格式化成十六进制行和串口输出都推迟到系统工作队列，
+// 攒 TAP_LOG_FLUSH_MS 后一次输出，敲击过程中的多条日志不会拖慢采样处理。
+
+#define TAP_LOG_RING_SIZE   32      // 2的幂
+#define TAP_LOG_FLUSH_MS    50
+
+SPSC_RING_DEFINE(log_ring, TapLogRecord, TAP_LOG_RING_SIZE);
+
+static void log_flush_handler(struct k_work *work)
+{
+    static char line[TAP_LOG_LINE_MAX];
+    TapLogRecord rec;
+
+    ARG_UNUSED(work);
+
+    while (spsc_ring_get(&log_ring, &rec)) {
+        tap_log_encode_line(&rec, line);
+        printk("%s\n", line);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(log_flush_work, log_flush_handler);
+
+void tap_log_uart_put(const TapLogRecord *rec)
+{
+    spsc_ring_put(&log_ring, rec);
+    // 已在等待中的flush不会被推迟
+    k_work_schedule(&log_flush_work, K_MSEC(TAP_LOG_FLUSH_MS));
+}
+
+uint32_t tap_log_uart_dropped(void)
+{
+    return (uint32_t)atomic_get(&log_ring.overruns);
+}
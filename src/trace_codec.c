@@ -0,0 +1,157 @@
+#include "trace_codec.h"
+#include <errno.h>
+#include <string.h>
+
+static void wr_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void wr_u32(uint8_t *p, uint32_t v)
+{
+    wr_u16(p, (uint16_t)v);
+    wr_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t rd_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return rd_u16(p) | ((uint32_t)rd_u16(p + 2) << 16);
+}
+
+// ===== varint =====
+static int put_varint(uint8_t *p, uint32_t v)
+{
+    int n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// 越界或超过5字节返回-1
+static int get_varint(const uint8_t *p, const uint8_t *end, uint32_t *v)
+{
+    uint32_t r = 0;
+
+    for (int i = 0; i < 5 && p + i < end; i++) {
+        r |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            *v = r;
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+static inline uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// ===== 编码 =====
+static void set_prev(TraceBlockEnc *enc, const AccelSample *s)
+{
+    enc->prev_ts = (uint32_t)s->ts;
+    enc->prev[0] = s->ax;
+    enc->prev[1] = s->ay;
+    enc->prev[2] = s->az;
+}
+
+void trace_block_start(TraceBlockEnc *enc, uint8_t *blk, uint32_t seq, const AccelSample *s)
+{
+    enc->blk = blk;
+    enc->len = TRACE_BLOCK_HDR_SIZE;
+    enc->count = 1;
+    set_prev(enc, s);
+
+    wr_u32(&blk[0], seq);
+    wr_u32(&blk[4], (uint32_t)s->ts);
+    wr_u16(&blk[8], (uint16_t)s->ax);
+    wr_u16(&blk[10], (uint16_t)s->ay);
+    wr_u16(&blk[12], (uint16_t)s->az);
+    wr_u16(&blk[14], enc->count);
+    wr_u16(&blk[16], enc->len);
+}
+
+bool trace_block_append(TraceBlockEnc *enc, const AccelSample *s)
+{
+    uint8_t tmp[TRACE_SAMPLE_MAX_BYTES];
+    int n = 0;
+
+    n += put_varint(&tmp[n], (uint32_t)s->ts - enc->prev_ts);
+    n += put_varint(&tmp[n], zigzag((int32_t)s->ax - enc->prev[0]));
+    n += put_varint(&tmp[n], zigzag((int32_t)s->ay - enc->prev[1]));
+    n += put_varint(&tmp[n], zigzag((int32_t)s->az - enc->prev[2]));
+    if (enc->len + n > TRACE_BLOCK_SIZE) {
+        return false;
+    }
+
+    memcpy(&enc->blk[enc->len], tmp, n);
+    enc->len += n;
+    enc->count++;
+    set_prev(enc, s);
+    wr_u16(&enc->blk[14], enc->count);
+    wr_u16(&enc->blk[16], enc->len);
+    return true;
+}
+
+// ===== 解码 =====
+int trace_block_decode(const uint8_t *blk, size_t size, uint32_t *seq,
+                       AccelSample *out, int max)
+{
+    if (size < TRACE_BLOCK_HDR_SIZE) {
+        return -EINVAL;
+    }
+
+    uint16_t count = rd_u16(&blk[14]);
+    uint16_t len = rd_u16(&blk[16]);
+    if (len < TRACE_BLOCK_HDR_SIZE || len > size || len > TRACE_BLOCK_SIZE || count == 0) {
+        return -EINVAL;
+    }
+
+    const uint8_t *p = &blk[TRACE_BLOCK_HDR_SIZE];
+    const uint8_t *end = &blk[len];
+    uint32_t ts = rd_u32(&blk[4]);
+    int32_t a[3] = {
+        (int16_t)rd_u16(&blk[8]), (int16_t)rd_u16(&blk[10]), (int16_t)rd_u16(&blk[12]),
+    };
+    int n = 0;
+
+    *seq = rd_u32(&blk[0]);
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            uint32_t v[4];
+            for (int k = 0; k < 4; k++) {
+                int used = get_varint(p, end, &v[k]);
+                if (used < 0) {
+                    return -EINVAL;
+                }
+                p += used;
+            }
+            ts += v[0];
+            for (int k = 0; k < 3; k++) {
+                a[k] += unzigzag(v[k + 1]);
+            }
+        }
+        if (n < max) {
+            out[n++] = (AccelSample){
+                .ax = (int16_t)a[0], .ay = (int16_t)a[1], .az = (int16_t)a[2], .ts = ts,
+            };
+        }
+    }
+    return p == end ? n : -EINVAL;
+}
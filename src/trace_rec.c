@@ -0,0 +1,472 @@
+#include "trace_rec.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/storage/flash_map.h>
+
+#define TRACE_PARTITION_ID  FIXED_PARTITION_ID(storage_partition)
+#define TRACE_FCB_MAGIC     0x53434b54      // "SCKT"
+#define TRACE_SECTORS_MAX   32
+#define TRACE_BLOCKS        (CONFIG_APP_TRACE_REC_RAM_SIZE / TRACE_BLOCK_SIZE)
+#define TRACE_ENTRY_MAX     (1 + TRACE_BLOCK_SIZE + 8)   // 类型字节 + 块 + 对齐填充
+#define TRACE_JOBS          4                           // 等待写入flash的窗口
+#define TRACE_WRITER_PRIORITY   10                      // 低于检测线程，擦扇区不挡住检测
+
+BUILD_ASSERT(TRACE_BLOCKS >= 2, "APP_TRACE_REC_RAM_SIZE must hold at least two blocks");
+
+// ===== RAM环形块 =====
+// 块序号seq存放在 blocks[seq % TRACE_BLOCKS]，只由检测线程写；写入线程只读已封口的块
+static uint8_t blocks[TRACE_BLOCKS][TRACE_BLOCK_SIZE] __aligned(4);
+static uint32_t blk_first_ts[TRACE_BLOCKS];
+static uint32_t blk_last_ts[TRACE_BLOCKS];
+static TraceBlockEnc enc;
+static uint32_t base_seq;               // 本次上电的第一个块，接在flash里已有的块之后
+static uint32_t cur_seq;                // 正在写的块
+static atomic_t head_seq;               // cur_seq 的副本，写入线程据此判断块是否已被覆盖
+static bool started;
+static bool seal_pending;               // 提交后当前块封口，下一个样本开新块
+
+// ===== 触发请求 =====
+static struct k_spinlock req_lock;
+static struct {
+    bool pending;
+    gesture_t reason;
+    int64_t ts;
+} req;
+static uint32_t req_dropped;
+
+static bool armed;                      // 等待触发点后 POST_MS 的样本
+static gesture_t arm_reason;
+static int64_t arm_ts;
+static bool have_auto;
+static int64_t last_auto_ts;            // 最近一次自动提交的触发时间
+
+// ===== 待写窗口（检测线程放入，写入线程取出）=====
+typedef struct {
+    gesture_t reason;
+    int64_t ts;
+    uint32_t first;                     // 窗口的首块和末块seq
+    uint32_t last;
+} trace_job_t;
+
+static struct k_spinlock job_lock;
+static trace_job_t jobs[TRACE_JOBS];
+static uint8_t job_head, job_len;
+
+// ===== flash（只由写入线程和shell命令访问）=====
+static struct fcb fcb;
+static struct flash_sector sectors[TRACE_SECTORS_MAX];
+static bool fcb_ok;
+static K_MUTEX_DEFINE(fcb_lock);        // 写入线程与shell读出/擦除互斥
+static atomic_t flash_cleared;          // "trace erase" 后RAM里的块需要重新写入
+static uint32_t flush_next;             // 第一个还没写入flash的块
+
+K_THREAD_STACK_DEFINE(writer_stack, CONFIG_APP_TRACE_REC_STACK_SIZE);
+static struct k_work_q writer_workq;
+
+static TraceRecStats stats;
+
+static int erase_partition(void)
+{
+    const struct flash_area *fa;
+    int ret = flash_area_open(TRACE_PARTITION_ID, &fa);
+
+    if (ret != 0) {
+        return ret;
+    }
+    ret = flash_area_erase(fa, 0, fa->fa_size);
+    flash_area_close(fa);
+    return ret;
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// flash里已有块的最大序号+1，不同次上电的块序号不重复，提取时不会混在一起
+static uint32_t scan_next_seq(void)
+{
+    struct fcb_entry loc = {0};
+    uint32_t next = 0;
+    uint8_t hdr[5];
+
+    while (fcb_getnext(&fcb, &loc) == 0) {
+        if (loc.fe_data_len < sizeof(hdr) ||
+            flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), hdr, sizeof(hdr)) != 0) {
+            continue;
+        }
+        if (hdr[0] == TRACE_ENTRY_BLOCK && rd_u32(&hdr[1]) >= next) {
+            next = rd_u32(&hdr[1]) + 1;
+        }
+    }
+    return next;
+}
+
+int trace_rec_init(void)
+{
+    uint32_t cnt = ARRAY_SIZE(sectors);
+    int ret = flash_area_get_sectors(TRACE_PARTITION_ID, &cnt, sectors);
+
+    if (ret != 0) {
+        return ret;
+    }
+    fcb.f_magic = TRACE_FCB_MAGIC;
+    fcb.f_version = 1;
+    fcb.f_sector_cnt = (uint8_t)cnt;
+    fcb.f_scratch_cnt = 0;
+    fcb.f_sectors = sectors;
+    ret = fcb_init(TRACE_PARTITION_ID, &fcb);
+    if (ret != 0) {
+        // 分区里是别的数据或格式版本不同：清掉重新开始
+        ret = erase_partition();
+        if (ret == 0) {
+            ret = fcb_init(TRACE_PARTITION_ID, &fcb);
+        }
+    }
+    fcb_ok = (ret == 0);
+    if (fcb_ok) {
+        const struct k_work_queue_config cfg = {
+            .name = "trace_rec",
+        };
+
+        base_seq = scan_next_seq();
+        cur_seq = base_seq;
+        atomic_set(&head_seq, cur_seq);
+        flush_next = base_seq;
+        k_work_queue_init(&writer_workq);
+        k_work_queue_start(&writer_workq, writer_stack, K_THREAD_STACK_SIZEOF(writer_stack),
+                           TRACE_WRITER_PRIORITY, &cfg);
+    }
+    return ret;
+}
+
+// 追加一个flash条目，空间不够时擦掉最旧的扇区
+static int fcb_put(uint8_t type, const uint8_t *data, size_t len)
+{
+    static uint8_t buf[TRACE_ENTRY_MAX] __aligned(4);
+    struct fcb_entry loc;
+    size_t total = ROUND_UP(1 + len, MAX(fcb.f_align, 1));
+    int ret;
+
+    buf[0] = type;
+    memcpy(&buf[1], data, len);
+    memset(&buf[1 + len], 0, total - 1 - len);
+
+    k_mutex_lock(&fcb_lock, K_FOREVER);
+    ret = fcb_append(&fcb, total, &loc);
+    if (ret == -ENOSPC) {
+        ret = fcb_rotate(&fcb);
+        if (ret == 0) {
+            ret = fcb_append(&fcb, total, &loc);
+        }
+    }
+    if (ret == 0) {
+        ret = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), buf, total);
+    }
+    if (ret == 0) {
+        ret = fcb_append_finish(&fcb, &loc);
+    }
+    k_mutex_unlock(&fcb_lock);
+
+    if (ret == 0) {
+        stats.flash_bytes += total;
+    }
+    return ret;
+}
+
+static void wr_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+// RAM里还保存着的最早一块
+static uint32_t oldest_seq(void)
+{
+    return cur_seq - base_seq >= TRACE_BLOCKS - 1 ? cur_seq - (TRACE_BLOCKS - 1) : base_seq;
+}
+
+// 块还在RAM里：检测线程开新块前先更新 head_seq，拷贝之后再检查即可发现拷贝期间被覆盖
+static bool block_in_ram(uint32_t seq)
+{
+    return (uint32_t)atomic_get(&head_seq) - seq <= TRACE_BLOCKS - 1;
+}
+
+// 写入线程：把窗口里还没写过的块和触发记录写入flash
+static void write_job(const trace_job_t *job)
+{
+    static uint8_t blk[TRACE_BLOCK_SIZE] __aligned(4);
+    uint8_t trig[TRACE_TRIGGER_SIZE] = {0};
+
+    if (atomic_cas(&flash_cleared, 1, 0)) {
+        flush_next = 0;
+    }
+    for (uint32_t seq = MAX(job->first, flush_next); seq <= job->last; seq++) {
+        memcpy(blk, blocks[seq % TRACE_BLOCKS], sizeof(blk));
+        if (!block_in_ram(seq)) {
+            // 写入落后太多，窗口开头已被新样本覆盖
+            stats.errors++;
+            return;
+        }
+
+        uint16_t len = (uint16_t)(blk[16] | (blk[17] << 8));
+
+        if (fcb_put(TRACE_ENTRY_BLOCK, blk, len) != 0) {
+            stats.errors++;
+            return;
+        }
+        flush_next = seq + 1;
+    }
+
+    trig[0] = (uint8_t)job->reason;
+    wr_u32(&trig[4], (uint32_t)job->ts);
+    wr_u32(&trig[8], job->first);
+    wr_u32(&trig[12], job->last);
+    if (fcb_put(TRACE_ENTRY_TRIGGER, trig, sizeof(trig)) != 0) {
+        stats.errors++;
+    }
+}
+
+static void writer_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    while (1) {
+        k_spinlock_key_t key = k_spin_lock(&job_lock);
+
+        if (job_len == 0) {
+            k_spin_unlock(&job_lock, key);
+            return;
+        }
+        trace_job_t job = jobs[job_head];
+
+        job_head = (job_head + 1) % TRACE_JOBS;
+        job_len--;
+        k_spin_unlock(&job_lock, key);
+
+        write_job(&job);
+    }
+}
+
+static K_WORK_DEFINE(writer_work, writer_handler);
+
+// 检测线程：确定触发点前 PRE_MS 起的块范围，封口当前块后交给写入线程，不等flash
+static void commit(gesture_t reason, int64_t ts)
+{
+    uint32_t from = (uint32_t)(ts - CONFIG_APP_TRACE_REC_PRE_MS);
+    uint32_t first = oldest_seq();
+
+    while (first < cur_seq && (int32_t)(blk_last_ts[first % TRACE_BLOCKS] - from) < 0) {
+        first++;
+    }
+    seal_pending = true;
+    stats.commits++;
+    if (!fcb_ok) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&job_lock);
+    bool queued = job_len < TRACE_JOBS;
+
+    if (queued) {
+        jobs[(job_head + job_len) % TRACE_JOBS] = (trace_job_t){
+            .reason = reason,
+            .ts = ts,
+            .first = first,
+            .last = cur_seq,
+        };
+        job_len++;
+    }
+    k_spin_unlock(&job_lock, key);
+
+    if (queued) {
+        k_work_submit_to_queue(&writer_workq, &writer_work);
+    } else {
+        stats.skipped++;
+    }
+}
+
+static void take_request(const AccelSample *s)
+{
+    k_spinlock_key_t key = k_spin_lock(&req_lock);
+    bool pending = req.pending;
+    gesture_t reason = req.reason;
+    int64_t ts = req.ts;
+
+    req.pending = false;
+    k_spin_unlock(&req_lock, key);
+
+    if (!pending) {
+        return;
+    }
+    if (reason == GESTURE_NONE) {
+        // 手动请求：用户在漏检/误检之后才发命令，只取已经记录的部分
+        commit(reason, s->ts);
+        return;
+    }
+    if (armed ||
+        (have_auto && ts - last_auto_ts < CONFIG_APP_TRACE_REC_AUTO_INTERVAL_S * 1000LL)) {
+        stats.skipped++;
+        return;
+    }
+    armed = true;
+    arm_reason = reason;
+    arm_ts = ts;
+}
+
+void trace_rec_put(const AccelSample *s)
+{
+    uint16_t before = enc.len;
+
+    if (started && !seal_pending && trace_block_append(&enc, s)) {
+        stats.enc_bytes += enc.len - before;
+    } else {
+        if (started) {
+            cur_seq++;
+            atomic_set(&head_seq, cur_seq);
+        }
+        uint32_t idx = cur_seq % TRACE_BLOCKS;
+        trace_block_start(&enc, blocks[idx], cur_seq, s);
+        blk_first_ts[idx] = (uint32_t)s->ts;
+        started = true;
+        seal_pending = false;
+        stats.enc_bytes += TRACE_BLOCK_HDR_SIZE;
+    }
+    blk_last_ts[cur_seq % TRACE_BLOCKS] = (uint32_t)s->ts;
+    stats.samples++;
+
+    stats.ram_span_ms = (uint32_t)s->ts - blk_first_ts[oldest_seq() % TRACE_BLOCKS];
+
+    take_request(s);
+    if (armed && s->ts - arm_ts >= CONFIG_APP_TRACE_REC_POST_MS) {
+        armed = false;
+        have_auto = true;
+        last_auto_ts = arm_ts;
+        commit(arm_reason, arm_ts);
+    }
+}
+
+// 上一个请求还没被检测线程取走时丢弃新请求
+void trace_rec_trigger(gesture_t reason, int64_t ts)
+{
+    k_spinlock_key_t key = k_spin_lock(&req_lock);
+
+    if (req.pending) {
+        req_dropped++;
+    } else {
+        req.pending = true;
+        req.reason = reason;
+        req.ts = ts;
+    }
+    k_spin_unlock(&req_lock, key);
+}
+
+// 统计在检测线程（flash_bytes/errors在写入线程）里更新，这里不加锁取快照，个别字段可能相差一个样本
+void trace_rec_get_stats(TraceRecStats *out)
+{
+    *out = stats;
+    out->skipped += req_dropped;
+}
+
+// ===== shell命令: trace status | save | dump | erase =====
+static int cmd_trace_status(const struct shell *sh, size_t argc, char **argv)
+{
+    TraceRecStats st;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    trace_rec_get_stats(&st);
+    shell_print(sh, "samples %u, %u.%02u bytes/sample, RAM %u blocks / %u ms",
+                st.samples, st.samples ? st.enc_bytes / st.samples : 0,
+                st.samples ? st.enc_bytes * 100 / st.samples % 100 : 0,
+                (unsigned int)TRACE_BLOCKS, st.ram_span_ms);
+    shell_print(sh, "commits %u, skipped %u, flash written %u bytes, errors %u%s",
+                st.commits, st.skipped, st.flash_bytes, st.errors,
+                fcb_ok ? "" : " (flash unavailable)");
+    return 0;
+}
+
+static int cmd_trace_save(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    trace_rec_trigger(GESTURE_NONE, 0);
+    shell_print(sh, "trace save requested");
+    return 0;
+}
+
+// 每个条目一行 "#TR:<hex>"，读flash时持锁，输出时放开，不挡住写入线程
+static int cmd_trace_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    static const char hex[] = "0123456789abcdef";
+    static uint8_t buf[TRACE_ENTRY_MAX];
+    static char line[sizeof(TRACE_LINE_PREFIX) + 2 * TRACE_ENTRY_MAX];
+    struct fcb_entry loc = {0};
+    int entries = 0;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    if (!fcb_ok) {
+        shell_error(sh, "flash unavailable");
+        return -ENODEV;
+    }
+
+    while (1) {
+        k_mutex_lock(&fcb_lock, K_FOREVER);
+        int ret = fcb_getnext(&fcb, &loc);
+        size_t len = MIN(loc.fe_data_len, sizeof(buf));
+        if (ret == 0) {
+            ret = flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), buf, len);
+        }
+        k_mutex_unlock(&fcb_lock);
+        if (ret != 0) {
+            break;
+        }
+
+        int pos = strlen(TRACE_LINE_PREFIX);
+        memcpy(line, TRACE_LINE_PREFIX, pos);
+        for (size_t i = 0; i < len; i++) {
+            line[pos++] = hex[buf[i] >> 4];
+            line[pos++] = hex[buf[i] & 0x0F];
+        }
+        line[pos] = '\0';
+        shell_print(sh, "%s", line);
+        entries++;
+    }
+    shell_print(sh, "%d entries", entries);
+    return 0;
+}
+
+static int cmd_trace_erase(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+    if (!fcb_ok) {
+        shell_error(sh, "flash unavailable");
+        return -ENODEV;
+    }
+
+    k_mutex_lock(&fcb_lock, K_FOREVER);
+    int ret = fcb_clear(&fcb);
+    k_mutex_unlock(&fcb_lock);
+    atomic_set(&flash_cleared, 1);
+    if (ret != 0) {
+        shell_error(sh, "erase failed: %d", ret);
+        return ret;
+    }
+    shell_print(sh, "trace flash erased");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_trace,
+    SHELL_CMD(status, NULL, "Recorder RAM/flash statistics", cmd_trace_status),
+    SHELL_CMD(save, NULL, "Commit the recorded samples to flash now", cmd_trace_save),
+    SHELL_CMD(dump, NULL, "Print flash entries as #TR: lines for trace_extract", cmd_trace_dump),
+    SHELL_CMD(erase, NULL, "Erase recorded traces", cmd_trace_erase),
+    SHELL_SUBCMD_SET_END
+);
+SHELL_CMD_REGISTER(trace, &sub_trace, "Field sensor trace recorder", NULL);
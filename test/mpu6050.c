@@ -1,421 +1,758 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
-#include <zephyr/drivers/i2c.h>
-#include <math.h>
-#include <string.h>
-
-#define I2C_NODE    DT_ALIAS(i2c0)
-#define MPU_ADDR    0x68
-#define ACCEL_SCALE 16384.0f
-#define SAMPLING_INTERVAL_MS 20
-
-// ===== 戒指优化的双击参数 =====
-#define TAP_SPIKE_TH        0.30f   // 突变阈值（稍微放宽）
-#define TAP_PEAK_ABS_TH     1.20f   // 绝对值阈值（稍微放宽）
-#define TAP_MIN_DURATION_MS 25      // 最小冲击持续时间
-#define TAP_COOLDOWN_MS     180     // 单次tap冷却
-#define DOUBLE_TAP_MIN_MS   100     // 双击最小间隔
-#define DOUBLE_TAP_MAX_MS   500     // 双击最大间隔
-#define DOUBLE_TAP_COOLDOWN 1000    // 双击事件冷却
-
-// ===== 戒指专用静止判定参数 =====
-#define STATIC_WIN          6       // 平衡响应速度和稳定性
-#define STATIC_VAR_TH       0.040f  // 放宽方差阈值（考虑手指微动）
-#define STATIC_DIFF_TH      0.15f   // 放宽差值阈值
-#define GRAVITY_TOLERANCE   0.18f   // 放宽重力偏差容忍度
-#define POSTURE_STABLE_TH   0.25f   // 放宽姿态稳定阈值
-
-// ===== 方向性检测参数 =====
-#define AXIS_DOMINANCE_MIN   0.8f   // 主轴最小强度
-#define AXIS_DOMINANCE_RATIO 1.4f   // 主轴优势比例（降低要求）
-#define TAP_CONSISTENCY_RATIO 2.5f  // 双击一致性比例（略放宽）
-
-// ===== 滑动检测参数 =====
-#define SMOOTH_WIN          3       // 平滑窗口大小
-#define CALIBRATION_SAMPLES 50      // 自校准样本数
-
-// ===== 常量定义 =====
-#define STAT_WIN_INIT_MIN   999.0f
-#define STAT_WIN_INIT_MAX  -999.0f
-#define GRAVITY_NOMINAL     1.0f
-
-typedef struct { 
-    float buff[STATIC_WIN]; 
-    int head, len; 
-} FwStaticWin;
+#include <zephyr/drivers/sensor.h>
+#include <drivers/sck_mpu6050.h>
+#include "tap_detector.h"
+#include "orient_filter.h"
+#include "spsc_ring.h"
+#include "stack_report.h"
+#include "stage_probe.h"
+#ifdef CONFIG_APP_INPUT_BUS
+#include "input_bus.h"
+#include "led_control.h"
+#include "motor_driver.h"
+#include "output_sched.h"
+#include "pwm_out.h"
+#endif
+#ifdef CONFIG_APP_RATE_GOVERNOR
+#include "rate_governor.h"
+#endif
+#ifdef CONFIG_APP_TRACE_REC
+#include "trace_rec.h"
+#endif
 
+// 芯片配置（上电采样率、FIFO水位、INT引脚）由设备树 sck,mpu6050 节点给出。
+// 检测器按样本时间戳工作，采样率不必等于 SAMPLING_INTERVAL_MS
+#define MPU_NODE             DT_COMPAT_GET_ANY_STATUS_OKAY(sck_mpu6050)
+#define MPU_BASE_PERIOD_MS   (DT_PROP(MPU_NODE, smplrt_div) + 1)
+#define STATUS_INTERVAL_MS   5000    // 状态日志间隔，按样本时间计
+#ifdef CONFIG_APP_MINIMAL
+BUILD_ASSERT(!IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT),
+             "APP_MINIMAL: float formatting must be off, build with minimal.conf");
+#endif
+
+#ifdef CONFIG_APP_MPU6050_FIFO
+#include <zephyr/rtio/rtio.h>
+
+#define FIFO_WATERMARK       DT_PROP(MPU_NODE, fifo_watermark)
+// 驱动一次最多排空两倍水位，防止读取被延迟时读不完
+#define FIFO_BATCH_MAX       (FIFO_WATERMARK * 2)
+BUILD_ASSERT(FIFO_WATERMARK > 0, "APP_MPU6050_FIFO needs fifo-watermark > 0");
+
+SENSOR_DT_READ_IODEV(mpu_iodev, MPU_NODE, {SENSOR_CHAN_ACCEL_XYZ, 0}, {SENSOR_CHAN_GYRO_XYZ, 0});
+// 两块缓冲：一块在驱动里读FIFO时，另一块在这里解码
+RTIO_DEFINE_WITH_MEMPOOL(mpu_rtio, 2, 2, 2, SCK_MPU6050_READ_BUF_SIZE(FIFO_BATCH_MAX), 4);
+#endif
+
+// ===== 采集 -> 检测 样本队列 =====
+// 采集线程只负责读传感器并入队，检测和打印在低优先级线程里做，
+// 检测器或printk偶尔变慢不会推迟下一次采样。
+#define SAMPLE_RING_SIZE     CONFIG_APP_SAMPLE_RING_SIZE
+#define DETECT_STACK_SIZE    CONFIG_APP_DETECT_STACK_SIZE
+#define DETECT_PRIORITY      7       // 低于采集所在的main线程
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+// 检测线程一次从队列取出的样本数：定点检测器整批先算模长和平滑，再逐样本判定
+#define DETECT_BATCH         8
+#else
+#define DETECT_BATCH         1
+#endif
+
+#if defined(CONFIG_APP_MOTION_WAKE) || defined(CONFIG_APP_RATE_GOVERNOR)
+#define WAKE_NONE            INT64_MIN
+#endif
+
+// 唤醒（运动唤醒、升速）随样本一起入队，检测线程在该样本之前补记，
+// 和样本严格同序，不会落在已处理的突变之后
 typedef struct {
-    float buff[SMOOTH_WIN];
-    int head, len;
-} SmoothWin;
-
-// ===== 平滑窗口操作 =====
-static void smooth_push(SmoothWin *w, float v) {
-    w->buff[w->head] = v;
-    w->head = (w->head + 1) % SMOOTH_WIN;
-    if (w->len < SMOOTH_WIN) w->len++;
+    ImuSample imu;
+#if defined(CONFIG_APP_MOTION_WAKE) || defined(CONFIG_APP_RATE_GOVERNOR)
+    int64_t wake_ts;                    // 补记的唤醒时间，WAKE_NONE 表示没有
+#endif
+} QueuedSample;
+
+SPSC_RING_DEFINE(sample_ring, QueuedSample, SAMPLE_RING_SIZE);
+static K_SEM_DEFINE(sample_sem, 0, 1);
+static K_THREAD_STACK_DEFINE(detect_stack, DETECT_STACK_SIZE);
+static struct k_thread detect_thread;
+
+#if !defined(CONFIG_APP_TAP_FIXED_POINT) || defined(CONFIG_APP_TAP_FIXED_POINT_CROSSCHECK)
+static TapDetector det;
+#endif
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+static TapDetectorQ det_q;
+#endif
+#ifdef CONFIG_APP_TAP_ROTATION_REJECT
+static OrientFilter orient;
+#endif
+
+#ifdef CONFIG_APP_MOTION_WAKE
+static int64_t motion_wake_ts = WAKE_NONE;  // 采集线程内：运动唤醒时间，随下一个入队样本带走
+#endif
+#ifdef CONFIG_APP_RATE_GOVERNOR
+static RateGovernor rate_gov;
+static atomic_t detector_idle;          // 检测线程每排空一次队列更新，采集线程据此调节采样率
+#endif
+
+// 陀螺仪+加速度融合出姿态，交给检测器区分敲击和转腕
+static void update_attitude(const ImuSample *imu)
+{
+#ifdef CONFIG_APP_TAP_ROTATION_REJECT
+    int16_t grav[3];
+
+    orient_filter_update(&orient, imu);
+    orient_filter_gravity(&orient, grav);
+#if !defined(CONFIG_APP_TAP_FIXED_POINT) || defined(CONFIG_APP_TAP_FIXED_POINT_CROSSCHECK)
+    tap_detector_set_attitude(&det, grav, orient.rate_dps);
+#endif
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+    tap_detector_q_set_attitude(&det_q, grav, orient.rate_dps);
+#endif
+#else
+    ARG_UNUSED(imu);
+#endif
 }
 
-static float smooth_avg(SmoothWin *w) {
-    if (w->len == 0) return 0.0f;
-    float sum = 0.0f;
-    for (int i = 0; i < w->len; i++) {
-        sum += w->buff[i];
+#ifdef CONFIG_APP_PM_RUNTIME
+// 运行时电源管理：I2C总线和各PWM控制器的挂起/唤醒次数
+static void pm_report(void)
+{
+    uint32_t resumes, suspends;
+
+    if (sck_mpu6050_bus_pm_stats(DEVICE_DT_GET(MPU_NODE), &resumes, &suspends) == 0) {
+        printk("PM i2c: suspends=%u resumes=%u\n", suspends, resumes);
     }
-    return sum / w->len;
-}
+#ifdef CONFIG_APP_INPUT_BUS
+    static const struct {
+        pwm_out_role_t role;
+        const char *name;
+    } outs[] = {
+        {PWM_OUT_RED, "led"},
+        {PWM_OUT_MOTOR, "motor"},
+    };
 
-// ===== 自校准结构 =====
-typedef struct {
-    float gravity_ref;
-    int sample_count;
-    float sum;
-    bool calibrated;
-} CalibrationState;
-
-// ===== 改进的窗口操作 =====
-static void win_push(FwStaticWin *w, float v) {
-    w->buff[w->head] = v; 
-    w->head = (w->head + 1) % STATIC_WIN;
-    if (w->len < STATIC_WIN) w->len++;
+    for (int i = 0; i < ARRAY_SIZE(outs); i++) {
+        struct pwm_out_pm_stats st;
+
+        if (pwm_out_get_pm_stats(outs[i].role, &st) == 0) {
+            printk("PM %s pwm: %s, suspends=%u resumes=%u max_resume=%u us errors=%u\n",
+                   outs[i].name, st.suspended ? "off" : "on", st.suspends, st.resumes,
+                   st.max_resume_us, st.errors);
+        }
+    }
+#endif
 }
+#endif
 
-static void win_stat(FwStaticWin *w, float *mean, float *var, float *minv, float *maxv) {
-    int i, l = w->len; 
-    *mean = 0; *var = 0; 
-    *maxv = STAT_WIN_INIT_MAX; 
-    *minv = STAT_WIN_INIT_MIN;
-    
-    if (l == 0) return;
-    
-    for (i = 0; i < l; i++) {
-        float v = w->buff[(w->head - l + i + STATIC_WIN) % STATIC_WIN];
-        *mean += v; 
-        if (v > *maxv) *maxv = v; 
-        if (v < *minv) *minv = v;
-    }
-    *mean /= l;
-    
-    for (i = 0; i < l; i++) {
-        float v = w->buff[(w->head - l + i + STATIC_WIN) % STATIC_WIN];
-        *var += (v - *mean) * (v - *mean);
-    }
-    *var /= l;
+#if defined(CONFIG_APP_MOTION_WAKE) || defined(CONFIG_APP_RATE_GOVERNOR)
+// 休眠期间的第一次敲击被运动中断代替，低速采样时被升速的突变代替，
+// 在带标记的样本之前补记
+static void wake_detector(int64_t ts)
+{
+#if !defined(CONFIG_APP_TAP_FIXED_POINT) || defined(CONFIG_APP_TAP_FIXED_POINT_CROSSCHECK)
+    tap_detector_wake(&det, ts);
+#endif
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+    tap_detector_q_wake(&det_q, ts);
+#endif
 }
+#endif
 
-// ===== MPU 初始化（增加错误处理）=====
-static int mpu6050_init(const struct device *i2c_dev) {
-    int ret;
-    
-    k_sleep(K_MSEC(100));
-    
-    uint8_t reset[] = {0x6B, 0x80};
-    ret = i2c_write(i2c_dev, reset, 2, MPU_ADDR);
-    if (ret != 0) {
-        printk("MPU6050 reset failed: %d\n", ret);
-        return ret;
+// ===== 单个样本处理 =====
+// mag/smooth 为定点检测器整批预处理的结果（见 tap_detector_q_prepare），浮点检测器不用
+static void process_sample(const ImuSample *imu, int32_t mag, int32_t smooth)
+{
+    static int64_t status_ts;
+    const AccelSample *s = &imu->acc;
+
+    STAGE_PROBE_BEGIN(t0);
+    update_attitude(imu);
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+    gesture_t evt = tap_detector_q_process_prepared(&det_q, s, mag, smooth);
+#if defined(CONFIG_APP_TAP_FIXED_POINT_CROSSCHECK)
+    // 浮点版本作为参考，逐样本比对事件输出
+    static uint32_t mismatch_count = 0;
+    gesture_t evt_ref = tap_detector_process(&det, s);
+    if (evt_ref != evt) {
+        mismatch_count++;
+        printk("Fixed-point mismatch @%lldms: float=%d fixed=%d (total %u)\n",
+               s->ts, evt_ref, evt, mismatch_count);
     }
-    k_sleep(K_MSEC(100));
-    
-    uint8_t wakeup[] = {0x6B, 0x01};
-    ret = i2c_write(i2c_dev, wakeup, 2, MPU_ADDR);
-    if (ret != 0) {
-        printk("MPU6050 wakeup failed: %d\n", ret);
-        return ret;
+#endif
+#else
+    gesture_t evt = tap_detector_process(&det, s);
+#endif
+    STAGE_PROBE_END(STAGE_DETECT, t0);
+#ifdef CONFIG_APP_INPUT_BUS
+    // 先发布再打印，printk同步输出会推迟LED/马达响应
+    if (evt != GESTURE_NONE) {
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+        input_bus_publish_gesture(&det_q.st.gc.last);
+#else
+        input_bus_publish_gesture(&det.st.gc.last);
+#endif
     }
-    k_sleep(K_MSEC(10));
-    
-    uint8_t sample_rate[] = {0x19, 0x07};
-    ret = i2c_write(i2c_dev, sample_rate, 2, MPU_ADDR);
-    if (ret != 0) {
-        printk("Sample rate config failed: %d\n", ret);
-        return ret;
+#endif
+    switch (evt) {
+    case GESTURE_SINGLE_TAP:
+        printk(">>> 戒指单击 <<<\n");
+        break;
+    case GESTURE_DOUBLE_TAP:
+        printk(">>> 戒指双击事件触发! <<<\n");
+        break;
+    case GESTURE_TRIPLE_TAP:
+        printk(">>> 戒指三击 <<<\n");
+        break;
+    case GESTURE_SHAKE:
+        printk(">>> 戒指晃动 <<<\n");
+        break;
+    case GESTURE_HOLD_STILL:
+        printk(">>> 戒指静止 <<<\n");
+        break;
+    default:
+        break;
     }
-    
-    uint8_t gyro_config[] = {0x1B, 0x00};
-    ret = i2c_write(i2c_dev, gyro_config, 2, MPU_ADDR);
-    if (ret != 0) {
-        printk("Gyro config failed: %d\n", ret);
-        return ret;
+
+#ifdef CONFIG_APP_TRACE_REC
+    // 放在发布之后；写flash交给记录器的写入线程，这里不阻塞
+    trace_rec_put(s);
+#ifdef CONFIG_APP_TRACE_REC_AUTO
+    if (evt != GESTURE_NONE && evt != GESTURE_HOLD_STILL) {
+        trace_rec_trigger(evt, s->ts);
     }
-    
-    uint8_t accel_config[] = {0x1C, 0x00};
-    ret = i2c_write(i2c_dev, accel_config, 2, MPU_ADDR);
-    if (ret != 0) {
-        printk("Accel config failed: %d\n", ret);
-        return ret;
+#endif
+#endif
+
+    // 定期输出状态信息
+    if (s->ts - status_ts >= STATUS_INTERVAL_MS) {
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+        printk("Status: gravity_ref=%d mg, calibrated=%s, acc=%d mg\n",
+               ACCEL_COUNTS_TO_MG(tap_detector_q_gravity_ref(&det_q)),
+               det_q.cal.calibrated ? "YES" : "NO", ACCEL_COUNTS_TO_MG(det_q.last_acc));
+#else
+        float gravity_ref = tap_detector_gravity_ref(&det);
+        printk("Status: gravity_ref=%.3f, calibrated=%s, acc_g=%.3f\n", 
+               gravity_ref, det.cal.calibrated ? "YES" : "NO", det.last_acc);
+#endif
+#ifdef CONFIG_APP_TAP_ROTATION_REJECT
+        int16_t grav[3];
+        orient_filter_gravity(&orient, grav);
+        printk("Attitude: gravity=(%d, %d, %d) mg, rate=%d dps\n",
+               ACCEL_COUNTS_TO_MG(grav[0]), ACCEL_COUNTS_TO_MG(grav[1]),
+               ACCEL_COUNTS_TO_MG(grav[2]), orient.rate_dps);
+#endif
+        printk("Sample ring: high_water=%d/%d, overruns=%d\n",
+               (int)atomic_get(&sample_ring.high_water), SAMPLE_RING_SIZE,
+               (int)atomic_get(&sample_ring.overruns));
+#ifdef CONFIG_APP_TAP_LOG_BINARY
+        printk("Tap log dropped: %u\n", tap_log_uart_dropped());
+#endif
+        stack_report_dump();
+#ifdef CONFIG_APP_PM_RUNTIME
+        pm_report();
+#endif
+#ifdef CONFIG_APP_INPUT_BUS
+        input_lat_stats_t lat;
+        input_latency_get(INPUT_SRC_TAP, INPUT_LAT_TOTAL, &lat);
+        printk("Tap->PWM latency: n=%u p50<=%u ms p95<=%u ms max=%u ms over %d ms=%u neg=%u"
+               " unchanged=%u\n",
+               lat.count, input_latency_percentile(&lat, 50), input_latency_percentile(&lat, 95),
+               lat.max_us / 1000, CONFIG_APP_INPUT_LATENCY_TARGET_MS, lat.over_target,
+               lat.negative, lat.no_change);
+#endif
+#ifdef CONFIG_APP_RATE_GOVERNOR
+        RateGovernorReport rr;
+        rate_governor_report(&rate_gov, s->ts, &rr);
+        printk("Sample rate: %d Hz now, avg %u.%u Hz, high %u.%u%%, ramps=%u\n",
+               rate_gov.hz, rr.avg_hz_x10 / 10, rr.avg_hz_x10 % 10,
+               rr.high_permille / 10, rr.high_permille % 10, rr.ramps);
+#endif
+        status_ts = s->ts;
     }
-    
-    printk("MPU6050 initialized successfully\n");
-    return 0;
 }
 
-static float calc_mag(int16_t ax, int16_t ay, int16_t az) {
-    float x = (float)ax / ACCEL_SCALE;
-    float y = (float)ay / ACCEL_SCALE; 
-    float z = (float)az / ACCEL_SCALE;
-    return sqrtf(x*x + y*y + z*z);
-}
+// ===== 检测线程：排空样本队列，按时间戳逐个送入检测器 =====
+static void detect_thread_entry(void *p1, void *p2, void *p3)
+{
+    static QueuedSample batch[DETECT_BATCH];
+    static int32_t mag[DETECT_BATCH], smooth[DETECT_BATCH];
+    int n;
 
-// ===== 改进的方向性检测 =====
-static bool is_intentional_tap_direction(int16_t ax, int16_t ay, int16_t az) {
-    float x = fabsf((float)ax / ACCEL_SCALE);
-    float y = fabsf((float)ay / ACCEL_SCALE);
-    float z = fabsf((float)az / ACCEL_SCALE);
-    
-    // 找出最大的轴向
-    float max_axis = fmaxf(fmaxf(x, y), z);
-    float sum_other = x + y + z - max_axis;
-    
-    // 改进的方向性检测逻辑
-    bool strong_enough = max_axis > AXIS_DOMINANCE_MIN;
-    bool dominant = max_axis > AXIS_DOMINANCE_RATIO * fmaxf(sum_other, 0.01f);
-    
-    return strong_enough && dominant;
-}
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
 
-// ===== 自校准功能 =====
-static void update_calibration(CalibrationState *cal, float acc_g, bool is_static) {
-    if (!is_static) return;
-    
-    if (cal->sample_count < CALIBRATION_SAMPLES) {
-        cal->sum += acc_g;
-        cal->sample_count++;
-        
-        if (cal->sample_count == CALIBRATION_SAMPLES) {
-            float new_ref = cal->sum / CALIBRATION_SAMPLES;
-            // 只有在合理范围内才更新参考值
-            if (fabsf(new_ref - GRAVITY_NOMINAL) < 0.3f) {
-                cal->gravity_ref = new_ref;
-                cal->calibrated = true;
-                printk("Gravity calibrated to %.3f\n", cal->gravity_ref);
-            } else {
-                printk("Calibration rejected: %.3f too far from nominal\n", new_ref);
-                cal->sample_count = 0;
-                cal->sum = 0.0f;
+    while (1) {
+        k_sem_take(&sample_sem, K_FOREVER);
+        do {
+            for (n = 0; n < DETECT_BATCH && spsc_ring_get(&sample_ring, &batch[n]); n++) {
             }
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+            tap_detector_q_prepare(&det_q, &batch[0].imu.acc, sizeof(batch[0]), n, mag, smooth);
+#endif
+            for (int i = 0; i < n; i++) {
+#if defined(CONFIG_APP_MOTION_WAKE) || defined(CONFIG_APP_RATE_GOVERNOR)
+                if (batch[i].wake_ts != WAKE_NONE) {
+                    wake_detector(batch[i].wake_ts);
+                }
+#endif
+                process_sample(&batch[i].imu, mag[i], smooth[i]);
+            }
+        } while (n == DETECT_BATCH);
+#ifdef CONFIG_APP_RATE_GOVERNOR
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+        atomic_set(&detector_idle, tap_detector_q_idle(&det_q));
+#else
+        atomic_set(&detector_idle, tap_detector_idle(&det));
+#endif
+#endif
+    }
+}
+
+// 队列满时丢弃新样本，丢弃数计入sample_ring.overruns。
+// wake_at: 升速时补记唤醒的样本下标，-1 表示没有；运动唤醒记在本批第一个样本上
+static void publish_samples(const ImuSample *batch, int n, int wake_at)
+{
+    for (int i = 0; i < n; i++) {
+        QueuedSample q = { .imu = batch[i] };
+
+#if defined(CONFIG_APP_MOTION_WAKE) || defined(CONFIG_APP_RATE_GOVERNOR)
+        q.wake_ts = i == wake_at ? batch[i].acc.ts : WAKE_NONE;
+#ifdef CONFIG_APP_MOTION_WAKE
+        if (i == 0 && motion_wake_ts != WAKE_NONE) {
+            q.wake_ts = motion_wake_ts;
+            motion_wake_ts = WAKE_NONE;
         }
+#endif
+#else
+        ARG_UNUSED(wake_at);
+#endif
+        spsc_ring_put(&sample_ring, &q);
+    }
+    if (n > 0) {
+        k_sem_give(&sample_sem);
     }
 }
 
-static float get_gravity_reference(CalibrationState *cal) {
-    return cal->calibrated ? cal->gravity_ref : GRAVITY_NOMINAL;
+#ifdef CONFIG_APP_MOTION_WAKE
+#include <zephyr/pm/device.h>
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+#include <zephyr/pm/device_runtime.h>
+#endif
+#include "motion_wake.h"
+
+// ===== 静止休眠 / 运动唤醒 =====
+static MotionWake motion_wake;
+static K_SEM_DEFINE(wake_sem, 0, 1);
+static bool motion_wake_ok;
+
+static void mpu_motion_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(trig);
+    k_sem_give(&wake_sem);
 }
 
-// ===== 改进的姿态稳定性检测 =====
-static bool is_posture_stable(FwStaticWin *win, float gravity_ref) {
-    float mean, var, minv, maxv;
-    win_stat(win, &mean, &var, &minv, &maxv);
-    
-    if (win->len < STATIC_WIN) return false;
-    
-    // 使用自校准的重力参考值
-    bool low_variance = (var < STATIC_VAR_TH);
-    bool small_range = (maxv - minv < STATIC_DIFF_TH);
-    bool near_gravity = (fabsf(mean - gravity_ref) < POSTURE_STABLE_TH);
-    
-    return low_variance && small_range && near_gravity;
+static int motion_wake_setup(const struct device *mpu)
+{
+    static const struct sensor_trigger motion = {
+        .type = SENSOR_TRIG_MOTION,
+        .chan = SENSOR_CHAN_ACCEL_XYZ,
+    };
+    struct sensor_value th;
+    struct sensor_value dur = {1, 0};
+    MotionWakeCfg cfg;
+
+    motion_wake_default_cfg(&cfg);
+    cfg.enter_ms = CONFIG_APP_MOTION_WAKE_IDLE_MS;
+    cfg.lp_hz = CONFIG_APP_MOTION_WAKE_LP_HZ;
+    cfg.wake_th = CONFIG_APP_MOTION_WAKE_THRESHOLD_MG * (int32_t)ACCEL_SCALE / 1000;
+    motion_wake_init(&motion_wake, &cfg, k_uptime_get());
+
+    sensor_ug_to_ms2(CONFIG_APP_MOTION_WAKE_THRESHOLD_MG * 1000, &th);
+    sensor_attr_set(mpu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SLOPE_TH, &th);
+    sensor_attr_set(mpu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SLOPE_DUR, &dur);
+    int ret = sensor_trigger_set(mpu, &motion, mpu_motion_handler);
+    motion_wake_ok = (ret == 0);
+    return ret;
 }
 
-// ===== 双击一致性检测 =====
-static bool taps_are_consistent(float mag1, float mag2) {
-    if (mag1 <= 0 || mag2 <= 0) return false;
-    
-    float ratio = mag1 > mag2 ? mag1 / mag2 : mag2 / mag1;
-    return ratio < TAP_CONSISTENCY_RATIO;
+static void bus_pm(enum pm_device_action action)
+{
+#ifdef CONFIG_PM_DEVICE
+    const struct device *bus = DEVICE_DT_GET(DT_BUS(MPU_NODE));
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    // 总线由驱动按访问取得/释放，休眠时已经挂起，不能再手动切换
+    if (pm_device_runtime_is_enabled(bus)) {
+        return;
+    }
+#endif
+    int ret = pm_device_action_run(bus, action);
+
+    if (ret != 0 && ret != -EALREADY && ret != -ENOSYS && ret != -ENOTSUP) {
+        printk("I2C bus PM action %d failed: %d\n", action, ret);
+    }
+#else
+    ARG_UNUSED(action);
+#endif
 }
 
-// ===== 改进的双击检测器 =====
-typedef struct {
-    int64_t last_tap_ts;
-    int64_t last_double_ts;
-    int tap_ready;
-    int tap_cd;
-    float first_tap_magnitude;
-    int64_t tap_start_ts;
-    bool tap_in_progress;
-    SmoothWin smooth_win;        // 平滑窗口
-    float last_smooth_acc;       // 上一次的平滑值
-} DoubleTapState;
-
-static int detect_double_tap_ring(int16_t ax, int16_t ay, int16_t az, 
-                                  float acc_g, 
-                                  FwStaticWin *stat_win, 
-                                  DoubleTapState *st,
-                                  CalibrationState *cal)
+// 芯片切到低功耗运动检测、挂起总线，阻塞到运动中断后恢复全速采样
+static void idle_until_motion(const struct device *mpu, const AccelSample *last)
 {
+    struct sensor_value lp = {CONFIG_APP_MOTION_WAKE_LP_HZ, 0};
+    struct sensor_value normal = {0, 0};
+    MotionWakeReport r;
     int64_t now = k_uptime_get();
-    float gravity_ref = get_gravity_reference(cal);
-    
-    // 平滑处理
-    smooth_push(&st->smooth_win, acc_g);
-    float smooth_acc = smooth_avg(&st->smooth_win);
-    
-    // 更新冷却计数器
-    if (st->tap_cd > 0) {
-        st->tap_cd -= SAMPLING_INTERVAL_MS;
-        if (st->tap_cd < 0) st->tap_cd = 0;
-    }
-    
-    // 检查基本条件
-    bool posture_stable = is_posture_stable(stat_win, gravity_ref);
-    bool near_gravity = fabsf(smooth_acc - gravity_ref) < GRAVITY_TOLERANCE;
-    bool good_direction = is_intentional_tap_direction(ax, ay, az);
-    
-    // 更新自校准
-    update_calibration(cal, smooth_acc, posture_stable && near_gravity);
-    
-    // 基本环境检查 - 放宽条件
-    if (!posture_stable && !near_gravity) {
-        // 环境不稳定，但不立即重置状态，给一定容忍度
-        if (!st->tap_in_progress) {
-            return 0;
+
+    motion_wake_enter(&motion_wake, last, now);
+    motion_wake_report(&motion_wake, now, &r);
+    printk("Idle: wakeups=%u (%u/h), idle=%u.%u%%, est %u uA (always-on %u uA)\n",
+           r.wakeups, r.wakeups_per_hour, r.idle_permille / 10, r.idle_permille % 10,
+           r.avg_ua, r.always_on_ua);
+
+    k_sem_reset(&wake_sem);
+    if (sensor_attr_set(mpu, SENSOR_CHAN_ACCEL_XYZ,
+                        (enum sensor_attribute)SENSOR_ATTR_SCK_MPU6050_LOW_POWER, &lp) == 0) {
+        bus_pm(PM_DEVICE_ACTION_SUSPEND);
+        k_sem_take(&wake_sem, K_FOREVER);
+        now = k_uptime_get();
+        bus_pm(PM_DEVICE_ACTION_RESUME);
+    }
+    if (sensor_attr_set(mpu, SENSOR_CHAN_ACCEL_XYZ,
+                        (enum sensor_attribute)SENSOR_ATTR_SCK_MPU6050_LOW_POWER, &normal) != 0) {
+        sck_mpu6050_recover(mpu);
+    }
+
+    motion_wake_exit(&motion_wake, now);
+    motion_wake_ts = now;
+}
+
+// 采集线程里逐样本判断静止，够久就进入休眠
+static void motion_wake_track(const struct device *mpu, const ImuSample *batch, int n)
+{
+    if (!motion_wake_ok) {
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (motion_wake_feed(&motion_wake, &batch[i].acc)) {
+            idle_until_motion(mpu, &batch[n - 1].acc);
+            return;
         }
     }
-    
-    // 使用平滑后的突变检测
-    float acc_spike = smooth_acc - st->last_smooth_acc;
-    
-    // 检测敲击开始
-    if (!st->tap_in_progress && acc_spike > TAP_SPIKE_TH && smooth_acc > TAP_PEAK_ABS_TH && st->tap_cd == 0) {
-        if (good_direction || near_gravity) { // 降低方向性要求
-            st->tap_in_progress = true;
-            st->tap_start_ts = now;
-            printk("Tap start detected (smooth_acc: %.2f, spike: %.2f)\n", smooth_acc, acc_spike);
+}
+#else
+static inline int motion_wake_setup(const struct device *mpu) { ARG_UNUSED(mpu); return 0; }
+static inline void motion_wake_track(const struct device *mpu, const ImuSample *batch, int n)
+{
+    ARG_UNUSED(mpu);
+    ARG_UNUSED(batch);
+    ARG_UNUSED(n);
+}
+#endif /* CONFIG_APP_MOTION_WAKE */
+
+// 连续出错时让驱动重新复位芯片
+static void check_error(const struct device *mpu, int ret, int *error_count)
+{
+    if (ret >= 0) {
+        *error_count = 0;
+        return;
+    }
+    if (++(*error_count) > 10) {
+        printk("I2C communication errors, reinitializing...\n");
+        sck_mpu6050_recover(mpu);
+        *error_count = 0;
+    }
+}
+
+#ifdef CONFIG_APP_MPU6050_FIFO
+static K_SEM_DEFINE(fifo_sem, 0, 1);
+static int sample_period_ms = MPU_BASE_PERIOD_MS;
+
+// 驱动每累计一个水位的样本回调一次（驱动工作队列上下文）
+static void mpu_drdy_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(trig);
+    k_sem_give(&fifo_sem);
+}
+
+// 把驱动的q31帧还原成原始计数，时间戳取传感器采样序号推算的时间。
+// 加速度和陀螺仪来自同一次burst的同一批帧，按下标一一对应
+static int decode_batch(const struct sensor_decoder_api *decoder, const uint8_t *buf,
+                        ImuSample *out, int max)
+{
+    static struct {
+        struct sensor_three_axis_data hdr;
+        struct sensor_three_axis_sample_data extra[FIFO_BATCH_MAX - 1];
+    } frames;
+    struct sensor_chan_spec acc_ch = {SENSOR_CHAN_ACCEL_XYZ, 0};
+    struct sensor_chan_spec gyro_ch = {SENSOR_CHAN_GYRO_XYZ, 0};
+    uint32_t fit = 0;
+    int n = 0;
+
+    // 低采样率下解码器可能分几次返回（32位时间差放不下整批），每段有自己的基准时间
+    while (n < max) {
+        int got = decoder->decode(buf, acc_ch, &fit, max - n, &frames.hdr);
+
+        if (got <= 0) {
+            break;
         }
+        for (int i = 0; i < got; i++) {
+            const struct sensor_three_axis_sample_data *r = &frames.hdr.readings[i];
+            ImuSample *o = &out[n + i];
+
+            o->acc.ax = sck_mpu6050_q31_to_counts(r->x);
+            o->acc.ay = sck_mpu6050_q31_to_counts(r->y);
+            o->acc.az = sck_mpu6050_q31_to_counts(r->z);
+            o->acc.ts = (int64_t)((frames.hdr.header.base_timestamp_ns + r->timestamp_delta) /
+                                  NSEC_PER_MSEC);
+        }
+        n += got;
     }
-    
-    // 检测敲击结束并确认
-    if (st->tap_in_progress) {
-        int64_t tap_duration = now - st->tap_start_ts;
-        
-        // 敲击持续时间足够长且现在回落
-        if (tap_duration >= TAP_MIN_DURATION_MS && acc_spike < -TAP_SPIKE_TH * 0.4f) {
-            st->tap_in_progress = false;
-            st->tap_cd = TAP_COOLDOWN_MS;
-            
-            printk("Tap end detected (duration: %lldms)\n", tap_duration);
-            
-            // 确认这是一次有效敲击
-            if (!st->tap_ready) {
-                // 第一次敲击
-                st->last_tap_ts = now;
-                st->first_tap_magnitude = smooth_acc;
-                st->tap_ready = 1;
-                printk("First tap confirmed (mag: %.2f)\n", smooth_acc);
-            } else {
-                // 第二次敲击
-                int64_t dt = now - st->last_tap_ts;
-                if (dt >= DOUBLE_TAP_MIN_MS && dt <= DOUBLE_TAP_MAX_MS) {
-                    // 检查双击一致性
-                    if (taps_are_consistent(st->first_tap_magnitude, smooth_acc)) {
-                        // 检查双击冷却
-                        if (now - st->last_double_ts > DOUBLE_TAP_COOLDOWN) {
-                            st->last_double_ts = now;
-                            st->tap_ready = 0;
-                            printk("Double tap confirmed! (dt: %lldms, mag1: %.2f, mag2: %.2f)\n", 
-                                   dt, st->first_tap_magnitude, smooth_acc);
-                            return 2; // 双击事件
-                        } else {
-                            printk("Double tap in cooldown period\n");
-                        }
-                    } else {
-                        printk("Inconsistent tap magnitudes: %.2f vs %.2f (ratio: %.2f)\n", 
-                               st->first_tap_magnitude, smooth_acc, 
-                               st->first_tap_magnitude / smooth_acc);
-                    }
-                } else {
-                    printk("Double tap timing out of range: %lldms\n", dt);
-                }
-                // 重置为新的第一次敲击
-                st->last_tap_ts = now;
-                st->first_tap_magnitude = smooth_acc;
-                printk("Reset to new first tap\n");
-            }
+
+    fit = 0;
+    for (int m = 0; m < n;) {
+        int got = decoder->decode(buf, gyro_ch, &fit, n - m, &frames.hdr);
+
+        if (got <= 0) {
+            return 0;
         }
-        // 敲击超时
-        else if (tap_duration > TAP_MIN_DURATION_MS * 4) {
-            st->tap_in_progress = false;
-            printk("Tap timeout after %lldms\n", tap_duration);
+        for (int i = 0; i < got; i++) {
+            const struct sensor_three_axis_sample_data *r = &frames.hdr.readings[i];
+            ImuSample *o = &out[m + i];
+
+            o->gx = sck_mpu6050_gyro_q31_to_counts(r->x);
+            o->gy = sck_mpu6050_gyro_q31_to_counts(r->y);
+            o->gz = sck_mpu6050_gyro_q31_to_counts(r->z);
         }
+        m += got;
     }
-    
-    // 双击超时重置
-    if (st->tap_ready && (now - st->last_tap_ts > DOUBLE_TAP_MAX_MS)) {
-        st->tap_ready = 0;
-        printk("Double tap timeout, reset\n");
+    return n;
+}
+
+#ifdef CONFIG_APP_RATE_GOVERNOR
+// ===== 自适应采样率 =====
+static bool rate_gov_ok;
+
+static int set_sample_rate(const struct device *mpu, int hz)
+{
+    struct sensor_value v = {hz, 0};
+    int ret = sensor_attr_set(mpu, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &v);
+
+    if (ret == 0) {
+        sample_period_ms = 1000 / hz;
     }
-    
-    st->last_smooth_acc = smooth_acc;
-    return 0;
+    return ret;
 }
 
-// ===== 主函数 =====
-void main(void)
+// 调节器从高速档开始，上电时芯片按设备树采样率，先切过去
+static int rate_governor_setup(const struct device *mpu)
 {
-    const struct device *i2c_dev = DEVICE_DT_GET(I2C_NODE);
-    if (!device_is_ready(i2c_dev)) {
-        printk("I2C device not ready\n");
-        return;
+    RateGovernorCfg cfg;
+
+    rate_governor_default_cfg(&cfg);
+    cfg.low_hz = CONFIG_APP_RATE_LOW_HZ;
+    cfg.high_hz = CONFIG_APP_RATE_HIGH_HZ;
+    cfg.hold_ms = CONFIG_APP_RATE_HOLD_MS;
+    cfg.wake_th = CONFIG_APP_RATE_WAKE_MG * (int32_t)ACCEL_SCALE / 1000;
+    rate_governor_init(&rate_gov, &cfg, k_uptime_get());
+
+    int ret = set_sample_rate(mpu, cfg.high_hz);
+    rate_gov_ok = (ret == 0);
+    return ret;
+}
+
+// 每批样本入队之前判断一次，在两次FIFO读取之间改芯片采样率。
+// 返回需要补记唤醒的样本下标（升速的那次突变），-1 表示没有
+static int rate_track(const struct device *mpu, const ImuSample *batch, int n)
+{
+    bool idle = atomic_get(&detector_idle);
+    int spike = -1;
+    int hz = 0;
+
+    if (!rate_gov_ok) {
+        return -1;
     }
-    
-    if (mpu6050_init(i2c_dev) != 0) {
-        printk("MPU6050 initialization failed\n");
-        return;
+    for (int i = 0; i < n; i++) {
+        int req = rate_governor_feed(&rate_gov, &batch[i].acc, idle);
+        if (req && !hz) {
+            hz = req;
+            spike = i;
+        }
     }
-    
-    static FwStaticWin static_win;
-    memset(&static_win, 0, sizeof(static_win));
-    
-    DoubleTapState st = {0};
-    CalibrationState cal = {GRAVITY_NOMINAL, 0, 0.0f, false};
-    
-    printk("Ring double-tap detector started...\n");
-    printk("Parameters: spike_th=%.2f, peak_th=%.2f, var_th=%.3f\n", 
-           TAP_SPIKE_TH, TAP_PEAK_ABS_TH, STATIC_VAR_TH);
-    printk("Calibration will start automatically...\n");
-    
+    if (!hz) {
+        return -1;
+    }
+
+    int ret = set_sample_rate(mpu, hz);
+    if (ret != 0) {
+        printk("Sample rate %d Hz failed: %d\n", hz, ret);
+        return -1;
+    }
+    rate_governor_commit(&rate_gov, hz, k_uptime_get());
+    // 低速档下的敲击可能不满足起始条件，升速的突变补记为连击的第一次敲击
+    return hz == rate_gov.cfg.high_hz ? spike : -1;
+}
+#else
+static inline int rate_governor_setup(const struct device *mpu) { ARG_UNUSED(mpu); return 0; }
+static inline int rate_track(const struct device *mpu, const ImuSample *batch, int n)
+{
+    ARG_UNUSED(mpu);
+    ARG_UNUSED(batch);
+    ARG_UNUSED(n);
+    return -1;
+}
+#endif /* CONFIG_APP_RATE_GOVERNOR */
+
+static void acquisition_loop(const struct device *mpu)
+{
+    static ImuSample batch[FIFO_BATCH_MAX];
+    static const struct sensor_trigger drdy = {
+        .type = SENSOR_TRIG_DATA_READY,
+        .chan = SENSOR_CHAN_ACCEL_XYZ,
+    };
+    const struct sensor_decoder_api *decoder;
     int error_count = 0;
-    int debug_counter = 0;
-    
+    int ret;
+
+    ret = sensor_get_decoder(mpu, &decoder);
+    if (ret == 0) {
+        ret = sensor_trigger_set(mpu, &drdy, mpu_drdy_handler);
+    }
+    if (ret != 0) {
+        printk("MPU6050 trigger setup failed: %d\n", ret);
+        return;
+    }
+    printk("MPU6050 FIFO enabled (watermark=%d samples)\n", FIFO_WATERMARK);
+    if (rate_governor_setup(mpu) != 0) {
+        printk("Rate governor setup failed, staying at %d ms\n", sample_period_ms);
+    }
+
     while (1) {
-        uint8_t reg_accel = 0x3B;
-        uint8_t accel_data[6];
-        
-        int ret = i2c_write_read(i2c_dev, MPU_ADDR, &reg_accel, 1, accel_data, 6);
+        // INT丢失时按当前采样率两倍水位时间兜底排空
+        k_sem_take(&fifo_sem, K_MSEC(FIFO_WATERMARK * sample_period_ms * 2));
+
+        // 读取在驱动工作队列里完成，这里只在完成队列上等待
+        STAGE_PROBE_BEGIN(t0);
+        ret = sensor_read_async_mempool(&mpu_iodev, &mpu_rtio, NULL);
+        if (ret != 0) {
+            check_error(mpu, ret, &error_count);
+            continue;
+        }
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&mpu_rtio);
+        STAGE_PROBE_END(STAGE_I2C_READ, t0);
+
+        uint8_t *buf;
+        uint32_t buf_len;
+        ret = cqe->result;
+        rtio_cqe_get_mempool_buffer(&mpu_rtio, cqe, &buf, &buf_len);
+        rtio_cqe_release(&mpu_rtio, cqe);
+
         if (ret == 0) {
-            error_count = 0; // 重置错误计数
-            
-            int16_t ax = (int16_t)((accel_data[0] << 8) | accel_data[1]);
-            int16_t ay = (int16_t)((accel_data[2] << 8) | accel_data[3]);
-            int16_t az = (int16_t)((accel_data[4] << 8) | accel_data[5]);
-            
-            float acc_g = calc_mag(ax, ay, az);
-            win_push(&static_win, acc_g);
-            
-            int evt = detect_double_tap_ring(ax, ay, az, acc_g, &static_win, &st, &cal);
-            if (evt == 2) {
-                printk(">>> 戒指双击事件触发! <<<\n");
-                // 这里可以添加你的双击响应代码
-            }
-            
-            // 定期输出状态信息
-            debug_counter++;
-            if (debug_counter >= 250) { // 每5秒输出一次
-                float gravity_ref = get_gravity_reference(&cal);
-                printk("Status: gravity_ref=%.3f, calibrated=%s, acc_g=%.3f\n", 
-                       gravity_ref, cal.calibrated ? "YES" : "NO", acc_g);
-                debug_counter = 0;
-            }
+            int n = decode_batch(decoder, buf, batch, FIFO_BATCH_MAX);
+            rtio_release_buffer(&mpu_rtio, buf, buf_len);
+            // 先判断升速，唤醒标记和触发它的样本一起入队
+            int wake_at = rate_track(mpu, batch, n);
+            publish_samples(batch, n, wake_at);
+            motion_wake_track(mpu, batch, n);
         } else {
-            error_count++;
-            if (error_count > 10) {
-                printk("I2C communication errors, reinitializing...\n");
-                mpu6050_init(i2c_dev);
-                error_count = 0;
-            }
+            rtio_release_buffer(&mpu_rtio, buf, buf_len);
         }
-        
-        k_sleep(K_MSEC(SAMPLING_INTERVAL_MS));
+        check_error(mpu, ret, &error_count);
+    }
+}
+#else
+static void acquisition_loop(const struct device *mpu)
+{
+    int error_count = 0;
+
+    while (1) {
+        struct sensor_value raw[3], raw_gyro[3];
+
+        STAGE_PROBE_BEGIN(t0);
+        int ret = sensor_sample_fetch(mpu);
+        STAGE_PROBE_END(STAGE_I2C_READ, t0);
+        if (ret == 0) {
+            // 一次fetch读出整帧，两个通道都取自同一次传输
+            sensor_channel_get(mpu, (enum sensor_channel)SENSOR_CHAN_SCK_MPU6050_RAW_XYZ, raw);
+            sensor_channel_get(mpu, (enum sensor_channel)SENSOR_CHAN_SCK_MPU6050_RAW_GYRO_XYZ,
+                               raw_gyro);
+
+            ImuSample s = {
+                .acc = {
+                    .ax = (int16_t)raw[0].val1,
+                    .ay = (int16_t)raw[1].val1,
+                    .az = (int16_t)raw[2].val1,
+                    .ts = k_uptime_get(),
+                },
+                .gx = (int16_t)raw_gyro[0].val1,
+                .gy = (int16_t)raw_gyro[1].val1,
+                .gz = (int16_t)raw_gyro[2].val1,
+            };
+            publish_samples(&s, 1, -1);
+            motion_wake_track(mpu, &s, 1);
+        }
+        check_error(mpu, ret, &error_count);
+
+        k_sleep(K_MSEC(MPU_BASE_PERIOD_MS));
     }
-}
\ No newline at end of file
+}
+#endif /* CONFIG_APP_MPU6050_FIFO */
+
+// ===== 主函数 =====
+void main(void)
+{
+    const struct device *mpu = DEVICE_DT_GET(MPU_NODE);
+    if (!device_is_ready(mpu)) {
+        printk("MPU6050 initialization failed\n");
+        return;
+    }
+
+#if !defined(CONFIG_APP_TAP_FIXED_POINT) || defined(CONFIG_APP_TAP_FIXED_POINT_CROSSCHECK)
+    tap_detector_init(&det, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+#endif
+#if defined(CONFIG_APP_TAP_FIXED_POINT)
+    tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+#endif
+#ifdef CONFIG_APP_TAP_ROTATION_REJECT
+    orient_filter_init(&orient);
+#endif
+#ifdef CONFIG_APP_TAP_LOG_BINARY
+    tap_detector_set_log_sink(tap_log_uart_put);
+#else
+    tap_detector_set_log(printk);
+#endif
+
+#ifdef CONFIG_APP_INPUT_BUS
+    // 敲击和按钮事件经输入总线驱动LED/马达，响应在 src/input_response.c
+    output_sched_init();
+    pwm_out_init();
+    led_control_init();
+    motor_driver_init();
+    input_response_init();
+#ifdef CONFIG_APP_INPUT_BUTTONS
+    button_input_init(input_bus_publish_button);
+#endif
+#endif
+
+#ifdef CONFIG_APP_TRACE_REC
+    if (trace_rec_init() != 0) {
+        printk("Trace recorder: flash unavailable, keeping samples in RAM only\n");
+    }
+#endif
+
+    k_thread_create(&detect_thread, detect_stack, K_THREAD_STACK_SIZEOF(detect_stack),
+                    detect_thread_entry, NULL, NULL, NULL,
+                    DETECT_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&detect_thread, "tap_detect");
+
+    if (motion_wake_setup(mpu) != 0) {
+        printk("Motion wake setup failed, staying at full rate\n");
+    }
+
+    printk("Ring double-tap detector started...\n");
+    printk("Calibration will start automatically...\n");
+
+    acquisition_loop(mpu);
+}
@@ -0,0 +1,174 @@
+#include "trace_io.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int trace_append(Trace *tr, const AccelSample *s, uint8_t label)
+{
+    if (tr->count == tr->cap) {
+        size_t cap = tr->cap ? tr->cap * 2 : 4096;
+        AccelSample *ns = realloc(tr->samples, cap * sizeof(*ns));
+        if (!ns) return -ENOMEM;
+        tr->samples = ns;
+        uint8_t *nl = realloc(tr->labels, cap);
+        if (!nl) return -ENOMEM;
+        tr->labels = nl;
+        tr->cap = cap;
+    }
+    tr->samples[tr->count] = *s;
+    tr->labels[tr->count] = label;
+    tr->count++;
+    return 0;
+}
+
+void trace_free(Trace *tr)
+{
+    free(tr->samples);
+    free(tr->labels);
+    memset(tr, 0, sizeof(*tr));
+}
+
+static uint16_t rd_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd_u32(const uint8_t *p) { return rd_u16(p) | ((uint32_t)rd_u16(p + 2) << 16); }
+static uint64_t rd_u64(const uint8_t *p) { return rd_u32(p) | ((uint64_t)rd_u32(p + 4) << 32); }
+
+static void wr_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr_u32(uint8_t *p, uint32_t v) { wr_u16(p, (uint16_t)v); wr_u16(p + 2, (uint16_t)(v >> 16)); }
+static void wr_u64(uint8_t *p, uint64_t v) { wr_u32(p, (uint32_t)v); wr_u32(p + 4, (uint32_t)(v >> 32)); }
+
+static int load_bin(FILE *f, Trace *tr)
+{
+    uint8_t hdr[TRACE_HDR_SIZE];
+    uint8_t rec[TRACE_REC_SIZE];
+
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) return -EIO;
+    if (rd_u16(&hdr[4]) != TRACE_VERSION || rd_u16(&hdr[6]) != TRACE_REC_SIZE) {
+        return -EINVAL;
+    }
+    uint32_t count = rd_u32(&hdr[8]);
+    int64_t ts = (int64_t)rd_u64(&hdr[12]);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (fread(rec, 1, sizeof(rec), f) != sizeof(rec)) return -EIO;
+        uint16_t dt = rd_u16(&rec[6]);
+        ts += dt & TRACE_DT_MAX_MS;
+        AccelSample s = {
+            .ax = (int16_t)rd_u16(&rec[0]),
+            .ay = (int16_t)rd_u16(&rec[2]),
+            .az = (int16_t)rd_u16(&rec[4]),
+            .ts = ts,
+        };
+        int ret = trace_append(tr, &s, (dt & TRACE_DT_LABEL) ? 1 : 0);
+        if (ret) return ret;
+    }
+    return 0;
+}
+
+static int load_csv(FILE *f, Trace *tr)
+{
+    char line[256];
+
+    while (fgets(line, sizeof(line), f)) {
+        long long ts;
+        int ax, ay, az, label = 0;
+        char *p = line;
+
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p != '-' && (*p < '0' || *p > '9')) continue;   // 注释/表头
+
+        int n = sscanf(p, "%lld ,%d ,%d ,%d ,%d", &ts, &ax, &ay, &az, &label);
+        if (n < 4) return -EINVAL;
+        AccelSample s = { (int16_t)ax, (int16_t)ay, (int16_t)az, ts };
+        int ret = trace_append(tr, &s, n == 5 && label ? 1 : 0);
+        if (ret) return ret;
+    }
+    return 0;
+}
+
+int trace_load(const char *path, Trace *tr)
+{
+    char magic[4];
+    FILE *f = fopen(path, "rb");
+    int ret;
+
+    if (!f) return -errno;
+    memset(tr, 0, sizeof(*tr));
+
+    if (fread(magic, 1, 4, f) == 4 && memcmp(magic, TRACE_MAGIC, 4) == 0) {
+        rewind(f);
+        ret = load_bin(f, tr);
+    } else {
+        rewind(f);
+        ret = load_csv(f, tr);
+    }
+    fclose(f);
+    if (ret) trace_free(tr);
+    return ret;
+}
+
+int trace_save_bin(const char *path, const Trace *tr)
+{
+    uint8_t hdr[TRACE_HDR_SIZE];
+    uint8_t rec[TRACE_REC_SIZE];
+    FILE *f = fopen(path, "wb");
+
+    if (!f) return -errno;
+
+    int64_t prev = tr->count ? tr->samples[0].ts : 0;
+    memcpy(hdr, TRACE_MAGIC, 4);
+    wr_u16(&hdr[4], TRACE_VERSION);
+    wr_u16(&hdr[6], TRACE_REC_SIZE);
+    wr_u32(&hdr[8], (uint32_t)tr->count);
+    wr_u64(&hdr[12], (uint64_t)prev);
+    fwrite(hdr, 1, sizeof(hdr), f);
+
+    for (size_t i = 0; i < tr->count; i++) {
+        const AccelSample *s = &tr->samples[i];
+        int64_t dt = s->ts - prev;
+        if (dt < 0 || dt > TRACE_DT_MAX_MS) {
+            fclose(f);
+            return -ERANGE;
+        }
+        prev = s->ts;
+        wr_u16(&rec[0], (uint16_t)s->ax);
+        wr_u16(&rec[2], (uint16_t)s->ay);
+        wr_u16(&rec[4], (uint16_t)s->az);
+        wr_u16(&rec[6], (uint16_t)dt | (tr->labels[i] ? TRACE_DT_LABEL : 0));
+        fwrite(rec, 1, sizeof(rec), f);
+    }
+    return fclose(f) == 0 ? 0 : -EIO;
+}
+
+size_t trace_label_count(const Trace *tr)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < tr->count; i++) {
+        n += tr->labels[i] ? 1 : 0;
+    }
+    return n;
+}
+
+size_t trace_score(const Trace *tr, const int64_t *events, size_t n_evt, int64_t tol_ms)
+{
+    size_t li = 0;
+    size_t tp = 0;
+    bool *used = calloc(tr->count ? tr->count : 1, sizeof(bool));
+
+    if (!used) return 0;
+    for (size_t e = 0; e < n_evt; e++) {
+        int64_t ts = events[e];
+
+        while (li < tr->count && (!tr->labels[li] || tr->samples[li].ts < ts - tol_ms)) li++;
+        for (size_t j = li; j < tr->count && tr->samples[j].ts <= ts + tol_ms; j++) {
+            if (tr->labels[j] && !used[j]) {
+                used[j] = true;
+                tp++;
+                break;
+            }
+        }
+    }
+    free(used);
+    return tp;
+}
@@ -0,0 +1,47 @@
+#ifndef TRACE_IO_H
+#define TRACE_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tap_detector.h"
+
+// 加速度回放数据，支持两种格式：
+//
+// CSV：每行 ts_ms,ax,ay,az[,label]，'#'开头或非数字开头的行忽略。
+//      label为1表示该样本处标注了一次双击（通常标在第二次敲击上）。
+//
+// 二进制(.sckt)：小端，20字节文件头 + 每样本8字节
+//      char     magic[4] = "SCKT"
+//      uint16_t version  = 1
+//      uint16_t rec_size = 8
+//      uint32_t count
+//      int64_t  t0_ms                 第一个样本的时间戳
+//      记录: int16_t ax, ay, az; uint16_t dt
+//            dt bit15 = label，bit0~14 = 与上一样本的间隔(ms)，首个样本相对t0
+
+#define TRACE_MAGIC         "SCKT"
+#define TRACE_VERSION       1
+#define TRACE_HDR_SIZE      20
+#define TRACE_REC_SIZE      8
+#define TRACE_DT_LABEL      0x8000
+#define TRACE_DT_MAX_MS     0x7FFF
+
+typedef struct {
+    AccelSample *samples;
+    uint8_t *labels;
+    size_t count;
+    size_t cap;
+} Trace;
+
+// 按文件魔数自动识别格式，成功返回0
+int trace_load(const char *path, Trace *tr);
+int trace_save_bin(const char *path, const Trace *tr);
+int trace_append(Trace *tr, const AccelSample *s, uint8_t label);
+void trace_free(Trace *tr);
+
+size_t trace_label_count(const Trace *tr);
+// 检测事件（按时间升序）与标注在 ±tol_ms 内贪心配对，每个标注最多匹配一次，返回命中数
+size_t trace_score(const Trace *tr, const int64_t *events, size_t n_evt, int64_t tol_ms);
+
+#endif
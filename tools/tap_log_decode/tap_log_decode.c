@@ -0,0 +1,174 @@
+// 检测器二进制日志解码工具
+//
+// 从控制台抓取的文本（文件或stdin）中找出 "#TL:" 行，按 include/tap_log.h
+// 的字典还原为文本，其余行原样输出。
+//
+//   tap_log_decode [-q] [log...]
+//     -q  只输出解码后的日志行
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tap_log.h"
+
+#define LINE_MAX_LEN 512
+
+#define X_FMT(name, lvl, fmt) fmt,
+#define X_NAME(name, lvl, fmt) #name,
+static const char *const dict_fmt[] = { TAP_LOG_DICT(X_FMT) };
+static const char *const dict_name[] = { TAP_LOG_DICT(X_NAME) };
+
+static int hex_val(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 解析一行的十六进制部分，失败返回-1
+static int parse_record(const char *hex, TapLogRecord *rec)
+{
+    uint8_t raw[8 + 4 * TAP_LOG_MAX_ARGS];
+    int n = 0;
+
+    while (n < (int)sizeof(raw)) {
+        int hi = hex_val(hex[0]);
+        int lo = hi < 0 ? -1 : hex_val(hex[1]);
+        if (hi < 0 || lo < 0) break;
+        raw[n++] = (uint8_t)((hi << 4) | lo);
+        hex += 2;
+    }
+    if (n < 8) return -1;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->id = (uint16_t)(raw[0] | (raw[1] << 8));
+    rec->nargs = raw[2];
+    rec->ts = rd_u32(&raw[4]);
+    if (rec->nargs > TAP_LOG_MAX_ARGS || n != 8 + 4 * rec->nargs) return -1;
+    for (int a = 0; a < rec->nargs; a++) {
+        rec->args[a] = rd_u32(&raw[8 + 4 * a]);
+    }
+    return 0;
+}
+
+// 按格式串逐个转换说明符渲染参数：f/e/g 取float原始位，d/i 取int32，u/x 取uint32
+static void render(const TapLogRecord *rec, FILE *out)
+{
+    const char *fmt = dict_fmt[rec->id];
+    int arg = 0;
+
+    fprintf(out, "[%10u ms] ", rec->ts);
+    while (*fmt) {
+        if (*fmt != '%') {
+            fputc(*fmt++, out);
+            continue;
+        }
+        if (fmt[1] == '%') {
+            fputc('%', out);
+            fmt += 2;
+            continue;
+        }
+
+        char spec[32];
+        size_t len = strcspn(fmt + 1, "diuxXfFeEgGs") + 2;
+        if (len >= sizeof(spec) || arg >= rec->nargs) {
+            fprintf(out, "<bad %s>\n", dict_name[rec->id]);
+            return;
+        }
+        memcpy(spec, fmt, len);
+        spec[len] = '\0';
+        // 去掉长度修饰，参数统一按32位处理
+        char conv = spec[len - 1];
+        size_t k = 1;
+        for (size_t i = 1; i < len; i++) {
+            if (spec[i] != 'l' && spec[i] != 'h' && spec[i] != 'z') spec[k++] = spec[i];
+        }
+        spec[k] = '\0';
+
+        uint32_t raw = rec->args[arg++];
+        switch (conv) {
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+            float f;
+            memcpy(&f, &raw, sizeof(f));
+            fprintf(out, spec, (double)f);
+            break;
+        }
+        case 'd': case 'i':
+            fprintf(out, spec, (int)(int32_t)raw);
+            break;
+        case 'u': case 'x': case 'X':
+            fprintf(out, spec, (unsigned)raw);
+            break;
+        default:
+            fprintf(out, "<bad %s>\n", dict_name[rec->id]);
+            return;
+        }
+        fmt += len;
+    }
+    if (arg != rec->nargs) {
+        fprintf(out, "<%s: %d extra args>\n", dict_name[rec->id], rec->nargs - arg);
+    }
+}
+
+static void decode_stream(FILE *in, bool quiet, size_t *decoded, size_t *bad)
+{
+    char line[LINE_MAX_LEN];
+
+    while (fgets(line, sizeof(line), in)) {
+        const char *p = strstr(line, TAP_LOG_LINE_PREFIX);
+        TapLogRecord rec;
+
+        if (!p) {
+            if (!quiet) fputs(line, stdout);
+            continue;
+        }
+        if (parse_record(p + strlen(TAP_LOG_LINE_PREFIX), &rec) != 0 ||
+            rec.id >= TAP_LOG_ID_COUNT) {
+            (*bad)++;
+            if (!quiet) printf("<undecodable> %s", line);
+            continue;
+        }
+        render(&rec, stdout);
+        (*decoded)++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool quiet = false;
+    size_t decoded = 0, bad = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "qh")) != -1) {
+        switch (opt) {
+        case 'q': quiet = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-q] [log...]\n", argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind >= argc) {
+        decode_stream(stdin, quiet, &decoded, &bad);
+    }
+    for (int i = optind; i < argc; i++) {
+        FILE *f = fopen(argv[i], "r");
+        if (!f) {
+            perror(argv[i]);
+            return 1;
+        }
+        decode_stream(f, quiet, &decoded, &bad);
+        fclose(f);
+    }
+
+    fprintf(stderr, "decoded %zu records, %zu undecodable\n", decoded, bad);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,384 @@
+// 主机端双击检测回放工具
+//
+// 把录制的加速度数据(CSV或.sckt二进制)按时间戳送入 tap_detector，
+// 与标注的双击事件比对给出 precision/recall，并统计每样本耗时和各手势事件数。
+// -w 仿真静止休眠/运动唤醒（motion_wake），报告唤醒次数和估算电流，
+// 同时检查休眠期间的双击是否仍能检出。
+// -g 仿真自适应采样率（rate_governor）：高速档即录制数据的采样率，低速档按
+// 给定频率抽取样本，报告平均采样率和送入检测器的样本数。
+// -x 浮点与定点检测器逐样本并行回放，输出事件不一致的每个样本，有不一致时返回1，
+// 用于在录制数据上回归验证定点实现（与固件 APP_TAP_FIXED_POINT_CROSSCHECK 相同的比对）。
+//
+//   tap_replay [-q] [-t 容差ms] [-r 重复次数] [-w 唤醒频率Hz] [-g 低速Hz] [-v|-b] trace...
+//   tap_replay -x trace...                   # 定点/浮点逐样本比对
+//   tap_replay -b trace | tap_log_decode     # 检查二进制日志与字典
+//   tap_replay -o out.sckt trace.csv      # 格式转换
+
+#include <getopt.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "motion_wake.h"
+#include "rate_governor.h"
+#include "tap_detector.h"
+#include "trace_io.h"
+
+#define DEFAULT_TOLERANCE_MS 300
+
+typedef struct {
+    size_t samples;
+    size_t fed;                 // 实际送入检测器的样本数（-g 时少于samples）
+    size_t labels;
+    size_t detected;
+    size_t tp, fp, fn;
+    size_t gestures[GESTURE_NUM];
+    double duration_s;
+    double elapsed_ns;
+} ReplayStats;
+
+static void log_stdout(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+// 与固件相同的 "#TL:" 行编码
+static void log_record_stdout(const TapLogRecord *rec)
+{
+    char line[TAP_LOG_LINE_MAX];
+    tap_log_encode_line(rec, line);
+    puts(line);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static TapDetector det;
+static TapDetectorQ det_q;
+
+static gesture_t detect(bool fixed, const AccelSample *s, GestureEvent *evt)
+{
+    gesture_t g = fixed ? tap_detector_q_process(&det_q, s) : tap_detector_process(&det, s);
+
+    *evt = fixed ? det_q.st.gc.last : det.st.gc.last;
+    return g;
+}
+
+static void detector_wake(bool fixed, int64_t ts)
+{
+    if (fixed) tap_detector_q_wake(&det_q, ts);
+    else tap_detector_wake(&det, ts);
+}
+
+// 录制数据的采样率，作为 -g 仿真的高速档
+static int trace_rate_hz(const Trace *tr)
+{
+    if (tr->count < 2 || tr->samples[tr->count - 1].ts <= tr->samples[0].ts) return 0;
+    return (int)((int64_t)(tr->count - 1) * 1000 /
+                 (tr->samples[tr->count - 1].ts - tr->samples[0].ts));
+}
+
+// 跑一遍检测器，把双击事件的时间（第二次敲击）写入 events，返回双击数；
+// 各手势的事件数累加到 counts。双击可能要等三击间隔超时才确认，所以按事件时间而非
+// 确认时所在样本评分。
+// mw 非NULL时仿真运动唤醒：休眠期间样本只做运动检测，唤醒后丢弃
+// MW_RESUME_MS 内的样本，再把唤醒记为第一次敲击。
+// rg 非NULL时仿真自适应采样率：低速档下按 low_hz 抽样，升速立即生效，
+// 和固件一样在样本送入检测器之前判断升速，升速的那次突变在该样本之前补记为第一次敲击。
+// 返回的 *fed 为送入检测器的样本数。
+static size_t run_once(const Trace *tr, bool fixed, MotionWake *mw, RateGovernor *rg,
+                       int64_t *events, size_t *counts, size_t *fed)
+{
+    int64_t resume_ts = INT64_MIN;
+    int64_t kept_ts = INT64_MIN;
+    bool wake_pending = false;
+    size_t n = 0;
+
+    *fed = 0;
+
+    if (fixed) {
+        tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    } else {
+        tap_detector_init(&det, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    }
+    if (mw && tr->count) {
+        MotionWakeCfg cfg = mw->cfg;
+        motion_wake_init(mw, &cfg, tr->samples[0].ts);
+    }
+    if (rg && tr->count) {
+        RateGovernorCfg cfg = rg->cfg;
+        rate_governor_init(rg, &cfg, tr->samples[0].ts);
+    }
+
+    for (size_t i = 0; i < tr->count; i++) {
+        const AccelSample *s = &tr->samples[i];
+
+        if (mw) {
+            if (mw->idle) {
+                if (motion_wake_sim_motion(mw, s)) {
+                    motion_wake_exit(mw, s->ts);
+                    resume_ts = s->ts + MW_RESUME_MS;
+                    wake_pending = true;
+                }
+                continue;
+            }
+            if (s->ts < resume_ts) {
+                continue;
+            }
+            if (wake_pending) {
+                detector_wake(fixed, resume_ts - MW_RESUME_MS);
+                wake_pending = false;
+            }
+        }
+        if (rg) {
+            if (rg->hz != rg->cfg.high_hz && kept_ts != INT64_MIN &&
+                s->ts - kept_ts < 1000 / rg->hz) {
+                continue;
+            }
+            kept_ts = s->ts;
+
+            bool idle = fixed ? tap_detector_q_idle(&det_q) : tap_detector_idle(&det);
+            bool was_low = rg->hz != rg->cfg.high_hz;
+            int hz = rate_governor_feed(rg, s, idle);
+            if (hz) {
+                if (was_low) detector_wake(fixed, s->ts);
+                rate_governor_commit(rg, hz, s->ts);
+            }
+        }
+
+        GestureEvent evt;
+        gesture_t g = detect(fixed, s, &evt);
+        (*fed)++;
+        if (g != GESTURE_NONE) {
+            counts[g]++;
+        }
+        if (g == GESTURE_DOUBLE_TAP) {
+            events[n++] = evt.ts;
+        }
+        if (mw && motion_wake_feed(mw, s)) {
+            motion_wake_enter(mw, s, s->ts);
+        }
+    }
+    return n;
+}
+
+static int replay(const char *path, bool fixed, int64_t tol_ms, int repeat, MotionWake *mw,
+                  RateGovernor *rg, ReplayStats *total)
+{
+    Trace tr;
+    ReplayStats st = {0};
+    int ret = trace_load(path, &tr);
+
+    if (ret) {
+        fprintf(stderr, "%s: load failed (%d)\n", path, ret);
+        return ret;
+    }
+
+    if (rg) {
+        rg->cfg.high_hz = trace_rate_hz(&tr);
+        if (rg->cfg.high_hz <= rg->cfg.low_hz) {
+            fprintf(stderr, "%s: trace rate %d Hz not above -g %d Hz\n", path,
+                    rg->cfg.high_hz, rg->cfg.low_hz);
+            trace_free(&tr);
+            return -1;
+        }
+    }
+
+    int64_t *events = malloc((tr.count + 1) * sizeof(int64_t));
+    size_t n_evt = 0;
+    size_t fed = 0;
+    double t0 = now_ns();
+    for (int r = 0; r < repeat; r++) {
+        memset(st.gestures, 0, sizeof(st.gestures));
+        n_evt = run_once(&tr, fixed, mw, rg, events, st.gestures, &fed);
+    }
+    st.elapsed_ns = now_ns() - t0;
+    st.samples = tr.count * repeat;
+    st.fed = fed * repeat;
+    if (tr.count > 1) {
+        st.duration_s = (tr.samples[tr.count - 1].ts - tr.samples[0].ts) / 1000.0 * repeat;
+    }
+    st.labels = trace_label_count(&tr);
+    st.detected = n_evt;
+    st.tp = trace_score(&tr, events, n_evt, tol_ms);
+    st.fp = st.detected - st.tp;
+    st.fn = st.labels - st.tp;
+
+    printf("%s: samples=%zu labels=%zu detected=%zu tp=%zu fp=%zu fn=%zu\n",
+           path, tr.count, st.labels, st.detected, st.tp, st.fp, st.fn);
+    printf("%s: gestures single=%zu double=%zu triple=%zu shake=%zu hold=%zu\n", path,
+           st.gestures[GESTURE_SINGLE_TAP], st.gestures[GESTURE_DOUBLE_TAP],
+           st.gestures[GESTURE_TRIPLE_TAP], st.gestures[GESTURE_SHAKE],
+           st.gestures[GESTURE_HOLD_STILL]);
+    if (mw && tr.count) {
+        MotionWakeReport r;
+        motion_wake_report(mw, tr.samples[tr.count - 1].ts, &r);
+        printf("%s: motion-wake lp=%dHz wakeups=%u (%u/h) idle=%.1f%% est=%u uA "
+               "(always-on %u uA)\n", path, mw->cfg.lp_hz, r.wakeups, r.wakeups_per_hour,
+               r.idle_permille / 10.0, r.avg_ua, r.always_on_ua);
+    }
+    if (rg && tr.count) {
+        RateGovernorReport r;
+        rate_governor_report(rg, tr.samples[tr.count - 1].ts, &r);
+        printf("%s: rate-governor %d/%d Hz avg=%.1f Hz high=%.1f%% ramps=%u fed=%zu/%zu "
+               "(%.1fx fewer)\n", path, rg->cfg.low_hz, rg->cfg.high_hz, r.avg_hz_x10 / 10.0,
+               r.high_permille / 10.0, r.ramps, fed, tr.count,
+               fed ? (double)tr.count / fed : 0.0);
+    }
+
+    total->samples += st.samples;
+    total->fed += st.fed;
+    total->labels += st.labels;
+    total->detected += st.detected;
+    total->tp += st.tp;
+    total->fp += st.fp;
+    total->fn += st.fn;
+    total->duration_s += st.duration_s;
+    total->elapsed_ns += st.elapsed_ns;
+
+    free(events);
+    trace_free(&tr);
+    return 0;
+}
+
+// 两套检测器逐样本比对：返回的手势不同，或同一手势的事件时间不同，都算不一致
+static int crosscheck(const char *path, size_t *mismatches)
+{
+    Trace tr;
+    size_t n = 0;
+    int ret = trace_load(path, &tr);
+
+    if (ret) {
+        fprintf(stderr, "%s: load failed (%d)\n", path, ret);
+        return ret;
+    }
+
+    tap_detector_init(&det, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+    for (size_t i = 0; i < tr.count; i++) {
+        const AccelSample *s = &tr.samples[i];
+        GestureEvent ef, eq;
+        gesture_t gf = detect(false, s, &ef);
+        gesture_t gq = detect(true, s, &eq);
+
+        if (gf != gq || (gf != GESTURE_NONE && ef.ts != eq.ts)) {
+            n++;
+            printf("%s: mismatch #%zu sample %zu @%lld ms: float=%d (evt %lld ms) "
+                   "fixed=%d (evt %lld ms)\n", path, n, i, (long long)s->ts,
+                   gf, gf != GESTURE_NONE ? (long long)ef.ts : -1LL,
+                   gq, gq != GESTURE_NONE ? (long long)eq.ts : -1LL);
+        }
+    }
+    printf("%s: crosscheck samples=%zu mismatches=%zu\n", path, tr.count, n);
+    *mismatches += n;
+    trace_free(&tr);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-q] [-t tol_ms] [-r repeat] [-w lp_hz] [-g low_hz] [-v|-b] trace...\n"
+            "       %s -x trace...\n"
+            "       %s -o out.sckt trace\n"
+            "  -q  use fixed-point detector\n"
+            "  -t  event/label match tolerance in ms (default %d)\n"
+            "  -r  replay each trace N times for timing (default 1)\n"
+            "  -w  simulate idle sleep / motion wake at the given low-power rate (1/5/20/40 Hz)\n"
+            "  -g  simulate the adaptive rate governor, decimating to low_hz while idle\n"
+            "  -v  print detector log\n"
+            "  -b  print detector log as binary #TL: records\n"
+            "  -x  run float and fixed-point detectors in lockstep, report every differing\n"
+            "      sample and exit 1 on any difference\n"
+            "  -o  convert a trace to binary format and exit\n",
+            prog, prog, prog, DEFAULT_TOLERANCE_MS);
+}
+
+int main(int argc, char **argv)
+{
+    bool fixed = false;
+    int64_t tol_ms = DEFAULT_TOLERANCE_MS;
+    int repeat = 1;
+    const char *out = NULL;
+    MotionWake mw;
+    bool wake = false;
+    RateGovernor rg;
+    bool governor = false;
+    bool cross = false;
+    int opt;
+
+    motion_wake_default_cfg(&mw.cfg);
+    rate_governor_default_cfg(&rg.cfg);
+
+    while ((opt = getopt(argc, argv, "qt:r:w:g:vbxo:h")) != -1) {
+        switch (opt) {
+        case 'q': fixed = true; break;
+        case 't': tol_ms = atoll(optarg); break;
+        case 'r': repeat = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'w': wake = true; mw.cfg.lp_hz = atoi(optarg); break;
+        case 'g':
+            governor = true;
+            rg.cfg.low_hz = atoi(optarg) > 0 ? atoi(optarg) : RG_LOW_HZ_DEFAULT;
+            break;
+        case 'v': tap_detector_set_log(log_stdout); break;
+        case 'b': tap_detector_set_log_sink(log_record_stdout); break;
+        case 'x': cross = true; break;
+        case 'o': out = optarg; break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (out) {
+        Trace tr;
+        int ret = trace_load(argv[optind], &tr);
+        if (ret == 0) ret = trace_save_bin(out, &tr);
+        if (ret) fprintf(stderr, "convert failed (%d)\n", ret);
+        else printf("%s: %zu samples -> %s\n", argv[optind], tr.count, out);
+        trace_free(&tr);
+        return ret ? 1 : 0;
+    }
+
+    if (cross) {
+        size_t mismatches = 0;
+        for (int i = optind; i < argc; i++) {
+            if (crosscheck(argv[i], &mismatches)) {
+                return 1;
+            }
+        }
+        printf("crosscheck: %zu mismatches\n", mismatches);
+        return mismatches ? 1 : 0;
+    }
+
+    ReplayStats total = {0};
+    for (int i = optind; i < argc; i++) {
+        if (replay(argv[i], fixed, tol_ms, repeat, wake ? &mw : NULL, governor ? &rg : NULL,
+                   &total)) {
+            return 1;
+        }
+    }
+
+    double precision = total.detected ? (double)total.tp / total.detected : 0.0;
+    double recall = total.labels ? (double)total.tp / total.labels : 0.0;
+    double ns_per_sample = total.fed ? total.elapsed_ns / total.fed : 0.0;
+    double speedup = total.elapsed_ns > 0 ? total.duration_s * 1e9 / total.elapsed_ns : 0.0;
+
+    printf("detector: %s\n", fixed ? "fixed-point" : "float");
+    printf("precision: %.3f  recall: %.3f  (tp=%zu fp=%zu fn=%zu)\n",
+           precision, recall, total.tp, total.fp, total.fn);
+    printf("throughput: %.1f ns/sample, %.0fx realtime\n", ns_per_sample, speedup);
+    return 0;
+}
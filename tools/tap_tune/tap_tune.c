@@ -0,0 +1,547 @@
+// 敲击检测阈值并行调参工具
+//
+// 在标注数据集上按参数网格（或随机搜索）反复回放 tap_detector，每组参数统计
+// 每小时误报数和漏检率，输出两者的Pareto前沿；-H 按误报预算挑出漏检最少的一组，
+// 生成与 include/tap_params.h 同格式的头文件，替换后直接构建固件。
+//
+// 多核并行用 fork 出的工作进程：检测器的日志状态是全局变量，线程会互相踩；
+// 数据集在 fork 前读入，各进程共享只读页，结果写进共享内存。
+//
+//   tap_tune [-q] [-j 进程数] [-n 随机组数] [-s 种子] [-t 容差ms] [-f 误报预算/h]
+//            [-o results.csv] [-H tap_params.h] [-p 名称[=min:max:step]]... trace...
+//
+//   tap_tune -p spike_th -p peak_abs_th -p gap_max_ms -H include/tap_params.h rec/*.sckt
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tap_detector.h"
+#include "trace_io.h"
+
+#define DEFAULT_TOLERANCE_MS    300
+#define DEFAULT_FP_BUDGET_H     1.0     // 默认误报预算：每小时1次
+#define MAX_PARAMS              16
+#define MAX_TRACES              256
+#define MAX_CONFIGS             2000000
+
+// 一组候选参数
+typedef struct {
+    TapParams tap;
+    GestureParams gest[GESTURE_NUM];
+} TuneConfig;
+
+typedef enum {
+    PARAM_TAP_FLOAT,
+    PARAM_TAP_INT,
+    PARAM_GESTURE_INT,          // 同时作用于双击和三击
+} param_kind_t;
+
+typedef struct {
+    const char *name;
+    const char *macro;          // tap_params.h 中对应的宏
+    param_kind_t kind;
+    size_t off;
+    double min, max, step;      // 默认扫描范围
+    bool sweep;                 // 未指定 -p 时默认扫描
+} ParamDesc;
+
+#define TAP_F(n, m, f, lo, hi, st, sw) { n, m, PARAM_TAP_FLOAT, offsetof(TapParams, f), lo, hi, st, sw }
+#define TAP_I(n, m, f, lo, hi, st, sw) { n, m, PARAM_TAP_INT, offsetof(TapParams, f), lo, hi, st, sw }
+#define GES_I(n, m, f, lo, hi, st, sw) { n, m, PARAM_GESTURE_INT, offsetof(GestureParams, f), lo, hi, st, sw }
+
+// 顺序即生成头文件中宏的顺序
+static const ParamDesc param_tab[] = {
+    TAP_F("spike_th",       "TAP_SPIKE_TH",         spike_th,          0.15, 0.50, 0.05,  true),
+    TAP_F("peak_abs_th",    "TAP_PEAK_ABS_TH",      peak_abs_th,       1.05, 1.50, 0.05,  true),
+    TAP_I("min_duration_ms","TAP_MIN_DURATION_MS",  min_duration_ms,   10,   50,   5,     true),
+    TAP_I("cooldown_ms",    "TAP_COOLDOWN_MS",      cooldown_ms,       100,  300,  20,    false),
+    GES_I("gap_min_ms",     "DOUBLE_TAP_MIN_MS",    gap_min_ms,        60,   200,  20,    false),
+    GES_I("gap_max_ms",     "DOUBLE_TAP_MAX_MS",    gap_max_ms,        300,  700,  50,    false),
+    TAP_F("static_var_th",  "STATIC_VAR_TH",        static_var_th,     0.010, 0.080, 0.010, false),
+    TAP_F("static_diff_th", "STATIC_DIFF_TH",       static_diff_th,    0.05, 0.30, 0.05,  false),
+    TAP_F("gravity_tol",    "GRAVITY_TOLERANCE",    gravity_tol,       0.10, 0.30, 0.02,  false),
+    TAP_F("posture_stable_th", "POSTURE_STABLE_TH", posture_stable_th, 0.10, 0.40, 0.05,  false),
+    TAP_F("axis_dom_min",   "AXIS_DOMINANCE_MIN",   axis_dom_min,      0.4,  1.2,  0.1,   true),
+    TAP_F("axis_dom_ratio", "AXIS_DOMINANCE_RATIO", axis_dom_ratio,    1.0,  2.4,  0.2,   false),
+    GES_I("consist_x10",    "TAP_CONSISTENCY_X10",  consist_x10,       15,   40,   5,     false),
+};
+
+#define PARAM_NUM (sizeof(param_tab) / sizeof(param_tab[0]))
+
+// 本次搜索的维度
+typedef struct {
+    const ParamDesc *d;
+    double min, max, step;
+    size_t n;                   // 网格点数
+} Axis;
+
+typedef struct {
+    bool valid;
+    size_t tp, fp, fn;
+    double fp_per_hour;
+    double miss_rate;
+} TuneResult;
+
+static Axis axes[MAX_PARAMS];
+static size_t n_axes;
+static Trace traces[MAX_TRACES];
+static size_t n_traces;
+static size_t total_labels;
+static double total_hours;
+static bool use_fixed;
+static bool random_search;
+static uint64_t seed = 1;
+static int64_t tol_ms = DEFAULT_TOLERANCE_MS;
+
+static const ParamDesc *param_find(const char *name, size_t len)
+{
+    for (size_t i = 0; i < PARAM_NUM; i++) {
+        if (strlen(param_tab[i].name) == len && strncmp(param_tab[i].name, name, len) == 0) {
+            return &param_tab[i];
+        }
+    }
+    return NULL;
+}
+
+static double param_get(const TuneConfig *c, const ParamDesc *d)
+{
+    switch (d->kind) {
+    case PARAM_TAP_FLOAT:
+        return *(const float *)((const char *)&c->tap + d->off);
+    case PARAM_TAP_INT:
+        return *(const int *)((const char *)&c->tap + d->off);
+    default:
+        return *(const uint16_t *)((const char *)&c->gest[GESTURE_DOUBLE_TAP] + d->off);
+    }
+}
+
+static void param_set(TuneConfig *c, const ParamDesc *d, double v)
+{
+    switch (d->kind) {
+    case PARAM_TAP_FLOAT:
+        *(float *)((char *)&c->tap + d->off) = (float)v;
+        break;
+    case PARAM_TAP_INT:
+        *(int *)((char *)&c->tap + d->off) = (int)(v + 0.5);
+        break;
+    default:
+        *(uint16_t *)((char *)&c->gest[GESTURE_DOUBLE_TAP] + d->off) = (uint16_t)(v + 0.5);
+        *(uint16_t *)((char *)&c->gest[GESTURE_TRIPLE_TAP] + d->off) = (uint16_t)(v + 0.5);
+        break;
+    }
+}
+
+// "name" 用默认范围，"name=min:max:step" 自定义；step为0表示只取min
+static int axis_add(const char *arg)
+{
+    const char *eq = strchr(arg, '=');
+    const ParamDesc *d = param_find(arg, eq ? (size_t)(eq - arg) : strlen(arg));
+    Axis a;
+
+    if (!d) {
+        fprintf(stderr, "unknown parameter '%s'\n", arg);
+        return -EINVAL;
+    }
+    if (n_axes == MAX_PARAMS) {
+        return -E2BIG;
+    }
+    a = (Axis){ .d = d, .min = d->min, .max = d->max, .step = d->step };
+    if (eq && sscanf(eq + 1, "%lf:%lf:%lf", &a.min, &a.max, &a.step) != 3) {
+        fprintf(stderr, "bad range '%s', expected name=min:max:step\n", arg);
+        return -EINVAL;
+    }
+    if (a.max < a.min || a.step < 0) {
+        fprintf(stderr, "bad range for %s\n", d->name);
+        return -EINVAL;
+    }
+    a.n = a.step > 0 ? (size_t)((a.max - a.min) / a.step + 1e-6) + 1 : 1;
+    axes[n_axes++] = a;
+    return 0;
+}
+
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 第 idx 组参数：0号固定为当前默认值作为基线，其余按网格展开或按种子随机取网格点。
+// 只依赖 idx，所以结果与进程数无关
+static void config_make(size_t idx, TuneConfig *c)
+{
+    c->tap = tap_params_default;
+    memcpy(c->gest, gesture_default_params, sizeof(c->gest));
+    if (idx == 0) {
+        return;
+    }
+    idx--;
+
+    uint64_t rng = seed ^ (idx * 0xD1B54A32D192ED03ULL);
+    for (size_t i = 0; i < n_axes; i++) {
+        size_t k;
+        if (random_search) {
+            k = (size_t)(splitmix64(&rng) % axes[i].n);
+        } else {
+            k = idx % axes[i].n;
+            idx /= axes[i].n;
+        }
+        param_set(c, axes[i].d, axes[i].min + k * axes[i].step);
+    }
+}
+
+static bool run_trace(const Trace *tr, const TuneConfig *c, int64_t *events, size_t *n_evt)
+{
+    static TapDetector det;
+    static TapDetectorQ det_q;
+    size_t n = 0;
+
+    if (use_fixed) {
+        tap_detector_q_init(&det_q, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+        TapParamsQ q;
+        tap_params_to_q(&c->tap, &q);
+        tap_detector_q_set_params(&det_q, &q);
+        if (tap_detector_q_set_gestures(&det_q, c->gest)) return false;
+    } else {
+        tap_detector_init(&det, STATIC_WIN_DEFAULT, SMOOTH_WIN_DEFAULT);
+        tap_detector_set_params(&det, &c->tap);
+        if (tap_detector_set_gestures(&det, c->gest)) return false;
+    }
+
+    for (size_t i = 0; i < tr->count; i++) {
+        const AccelSample *s = &tr->samples[i];
+        gesture_t g = use_fixed ? tap_detector_q_process(&det_q, s) : tap_detector_process(&det, s);
+
+        if (g == GESTURE_DOUBLE_TAP) {
+            events[n++] = use_fixed ? det_q.st.gc.last.ts : det.st.gc.last.ts;
+        }
+    }
+    *n_evt = n;
+    return true;
+}
+
+static void evaluate(size_t idx, int64_t *events, TuneResult *r)
+{
+    TuneConfig c;
+
+    config_make(idx, &c);
+    *r = (TuneResult){ .valid = true };
+    for (size_t t = 0; t < n_traces; t++) {
+        size_t n_evt;
+        if (!run_trace(&traces[t], &c, events, &n_evt)) {
+            r->valid = false;
+            return;
+        }
+        size_t tp = trace_score(&traces[t], events, n_evt, tol_ms);
+        r->tp += tp;
+        r->fp += n_evt - tp;
+    }
+    r->fn = total_labels - r->tp;
+    r->fp_per_hour = total_hours > 0 ? r->fp / total_hours : (double)r->fp;
+    r->miss_rate = total_labels ? (double)r->fn / total_labels : 0.0;
+}
+
+// 工作进程 w 处理 idx % workers == w 的参数组
+static int run_workers(size_t n_cfg, int workers, TuneResult *res)
+{
+    size_t max_count = 1;
+    for (size_t t = 0; t < n_traces; t++) {
+        if (traces[t].count > max_count) max_count = traces[t].count;
+    }
+
+    for (int w = 0; w < workers; w++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return -errno;
+        }
+        if (pid == 0) {
+            int64_t *events = malloc(max_count * sizeof(int64_t));
+            if (!events) _exit(1);
+            for (size_t i = w; i < n_cfg; i += workers) {
+                evaluate(i, events, &res[i]);
+            }
+            _exit(0);
+        }
+    }
+
+    int ret = 0;
+    int status;
+    while (wait(&status) > 0) {
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ret = -ECHILD;
+    }
+    return ret;
+}
+
+static void print_config(FILE *f, const TuneConfig *c, const char *sep)
+{
+    for (size_t i = 0; i < n_axes; i++) {
+        fprintf(f, "%s%g", i ? sep : "", param_get(c, axes[i].d));
+    }
+}
+
+static int write_csv(const char *path, const TuneResult *res, size_t n_cfg)
+{
+    FILE *f = fopen(path, "w");
+    TuneConfig c;
+
+    if (!f) return -errno;
+    fprintf(f, "idx");
+    for (size_t i = 0; i < n_axes; i++) fprintf(f, ",%s", axes[i].d->name);
+    fprintf(f, ",tp,fp,fn,fp_per_hour,miss_rate\n");
+    for (size_t i = 0; i < n_cfg; i++) {
+        if (!res[i].valid) continue;
+        config_make(i, &c);
+        fprintf(f, "%zu,", i);
+        print_config(f, &c, ",");
+        fprintf(f, ",%zu,%zu,%zu,%.3f,%.4f\n", res[i].tp, res[i].fp, res[i].fn,
+                res[i].fp_per_hour, res[i].miss_rate);
+    }
+    return fclose(f) == 0 ? 0 : -EIO;
+}
+
+static const TuneResult *sort_res;
+
+static int cmp_front(const void *a, const void *b)
+{
+    const TuneResult *ra = &sort_res[*(const size_t *)a];
+    const TuneResult *rb = &sort_res[*(const size_t *)b];
+
+    if (ra->fp_per_hour != rb->fp_per_hour) return ra->fp_per_hour < rb->fp_per_hour ? -1 : 1;
+    if (ra->miss_rate != rb->miss_rate) return ra->miss_rate < rb->miss_rate ? -1 : 1;
+    return *(const size_t *)a < *(const size_t *)b ? -1 : 1;
+}
+
+// 按误报升序排，漏检严格下降的点构成前沿，写入 front 返回点数
+static size_t pareto_front(const TuneResult *res, size_t n_cfg, size_t *front)
+{
+    size_t *order = malloc(n_cfg * sizeof(size_t));
+    size_t n = 0, m = 0;
+
+    if (!order) return 0;
+    for (size_t i = 0; i < n_cfg; i++) {
+        if (res[i].valid) order[n++] = i;
+    }
+    sort_res = res;
+    qsort(order, n, sizeof(size_t), cmp_front);
+
+    double best_miss = 2.0;
+    for (size_t i = 0; i < n; i++) {
+        if (res[order[i]].miss_rate < best_miss) {
+            best_miss = res[order[i]].miss_rate;
+            front[m++] = order[i];
+        }
+    }
+    free(order);
+    return m;
+}
+
+// 浮点宏保留一位以上小数并带f后缀
+static void fmt_float(char *buf, size_t len, double v)
+{
+    snprintf(buf, len, "%.4f", v);
+    char *end = buf + strlen(buf) - 1;
+    while (end[0] == '0' && end[-1] != '.') *end-- = '\0';
+    strncat(buf, "f", len - strlen(buf) - 1);
+}
+
+static int write_header(const char *path, const TuneConfig *c, const TuneResult *r,
+                        double budget, int argc, char **argv)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f) return -errno;
+    fprintf(f, "#ifndef TAP_PARAMS_H\n#define TAP_PARAMS_H\n\n");
+    fprintf(f, "// 由 tools/tap_tune 生成，请勿手工修改：\n//  ");
+    for (int i = 0; i < argc; i++) fprintf(f, " %s", argv[i]);
+    fprintf(f, "\n// %s检测器，误报预算 %.2f/h，%zu个标注、%.2fh数据上：\n",
+            use_fixed ? "定点" : "浮点", budget, total_labels, total_hours);
+    fprintf(f, "// tp=%zu fp=%zu fn=%zu，误报 %.2f/h，漏检率 %.1f%%\n\n",
+            r->tp, r->fp, r->fn, r->fp_per_hour, r->miss_rate * 100.0);
+
+    for (size_t i = 0; i < PARAM_NUM; i++) {
+        const ParamDesc *d = &param_tab[i];
+        char val[32];
+
+        if (d->kind == PARAM_TAP_FLOAT) {
+            fmt_float(val, sizeof(val), param_get(c, d));
+        } else {
+            snprintf(val, sizeof(val), "%d", (int)param_get(c, d));
+        }
+        fprintf(f, "#define %-20s %s\n", d->macro, val);
+    }
+    fprintf(f, "\n#endif\n");
+    return fclose(f) == 0 ? 0 : -EIO;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-q] [-j workers] [-n random] [-s seed] [-t tol_ms] [-f fp_per_hour]\n"
+            "          [-o results.csv] [-H tap_params.h] [-p name[=min:max:step]]... trace...\n"
+            "  -q  tune the fixed-point detector\n"
+            "  -j  worker processes (default: online CPUs)\n"
+            "  -n  random search with N configurations instead of the full grid\n"
+            "  -s  random search seed (default 1)\n"
+            "  -t  event/label match tolerance in ms (default %d)\n"
+            "  -f  false positives per hour allowed when picking the header config (default %.1f)\n"
+            "  -o  write every evaluated configuration as CSV\n"
+            "  -H  write the chosen configuration as a tap_params.h replacement\n"
+            "  -p  sweep a parameter; repeat for a grid (default: spike_th, peak_abs_th,\n"
+            "      min_duration_ms, axis_dom_min)\n"
+            "parameters:\n",
+            prog, DEFAULT_TOLERANCE_MS, DEFAULT_FP_BUDGET_H);
+    for (size_t i = 0; i < PARAM_NUM; i++) {
+        fprintf(stderr, "  %-18s %-22s %g:%g:%g\n", param_tab[i].name, param_tab[i].macro,
+                param_tab[i].min, param_tab[i].max, param_tab[i].step);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t n_random = 0;
+    double budget = DEFAULT_FP_BUDGET_H;
+    const char *csv = NULL;
+    const char *header = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "qj:n:s:t:f:o:H:p:h")) != -1) {
+        switch (opt) {
+        case 'q': use_fixed = true; break;
+        case 'j': workers = atol(optarg); break;
+        case 'n': n_random = strtoul(optarg, NULL, 0); random_search = n_random > 0; break;
+        case 's': seed = strtoull(optarg, NULL, 0); break;
+        case 't': tol_ms = atoll(optarg); break;
+        case 'f': budget = atof(optarg); break;
+        case 'o': csv = optarg; break;
+        case 'H': header = optarg; break;
+        case 'p': if (axis_add(optarg)) return 2; break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc || argc - optind > MAX_TRACES) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (workers < 1) workers = 1;
+    if (n_axes == 0) {
+        for (size_t i = 0; i < PARAM_NUM; i++) {
+            if (param_tab[i].sweep) axis_add(param_tab[i].name);
+        }
+    }
+
+    for (int i = optind; i < argc; i++) {
+        Trace *tr = &traces[n_traces];
+        int ret = trace_load(argv[i], tr);
+        if (ret) {
+            fprintf(stderr, "%s: load failed (%d)\n", argv[i], ret);
+            return 1;
+        }
+        n_traces++;
+        total_labels += trace_label_count(tr);
+        if (tr->count > 1) {
+            total_hours += (tr->samples[tr->count - 1].ts - tr->samples[0].ts) / 3600000.0;
+        }
+    }
+    if (total_labels == 0) {
+        fprintf(stderr, "warning: no labelled taps, miss rate is meaningless\n");
+    }
+
+    // 0号为默认参数
+    size_t n_cfg = 1;
+    if (random_search) {
+        n_cfg += n_random;
+    } else {
+        size_t grid = 1;
+        for (size_t i = 0; i < n_axes; i++) {
+            if (grid > MAX_CONFIGS / axes[i].n) {
+                fprintf(stderr, "grid too large (> %d), narrow the ranges or use -n\n",
+                        MAX_CONFIGS);
+                return 2;
+            }
+            grid *= axes[i].n;
+        }
+        n_cfg += grid;
+    }
+    if (n_cfg > MAX_CONFIGS + 1) {
+        fprintf(stderr, "too many configurations\n");
+        return 2;
+    }
+
+    TuneResult *res = mmap(NULL, n_cfg * sizeof(TuneResult), PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (res == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (run_workers(n_cfg, (int)workers, res)) {
+        fprintf(stderr, "worker failed\n");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    printf("detector: %s, traces=%zu labels=%zu hours=%.2f\n", use_fixed ? "fixed-point" : "float",
+           n_traces, total_labels, total_hours);
+    printf("search: %s, %zu configs, %ld workers, %.1f s\n", random_search ? "random" : "grid",
+           n_cfg, workers, secs);
+    printf("baseline: fp/h=%.2f miss=%.3f (tp=%zu fp=%zu fn=%zu)\n", res[0].fp_per_hour,
+           res[0].miss_rate, res[0].tp, res[0].fp, res[0].fn);
+
+    size_t *front = malloc(n_cfg * sizeof(size_t));
+    size_t n_front = front ? pareto_front(res, n_cfg, front) : 0;
+    TuneConfig c;
+
+    printf("pareto front (%zu points):\n%10s %8s  ", n_front, "fp/h", "miss");
+    for (size_t i = 0; i < n_axes; i++) printf("%s ", axes[i].d->name);
+    printf("\n");
+    for (size_t i = 0; i < n_front; i++) {
+        const TuneResult *r = &res[front[i]];
+        config_make(front[i], &c);
+        printf("%10.2f %8.3f  ", r->fp_per_hour, r->miss_rate);
+        print_config(stdout, &c, " ");
+        printf("%s\n", front[i] == 0 ? "  (default)" : "");
+    }
+
+    int ret = 0;
+    if (csv && (ret = write_csv(csv, res, n_cfg))) {
+        fprintf(stderr, "%s: write failed (%d)\n", csv, ret);
+    }
+
+    // 前沿按误报升序、漏检降序，预算内的最后一个点漏检最少
+    if (header) {
+        size_t pick = n_cfg;
+        for (size_t i = 0; i < n_front && res[front[i]].fp_per_hour <= budget; i++) {
+            pick = front[i];
+        }
+        if (pick == n_cfg) {
+            fprintf(stderr, "no configuration within %.2f fp/h, header not written\n", budget);
+            ret = ret ? ret : -ERANGE;
+        } else {
+            config_make(pick, &c);
+            ret = write_header(header, &c, &res[pick], budget, argc, argv);
+            if (ret) fprintf(stderr, "%s: write failed (%d)\n", header, ret);
+            else printf("header: %s (fp/h=%.2f miss=%.3f)\n", header, res[pick].fp_per_hour,
+                        res[pick].miss_rate);
+        }
+    }
+
+    free(front);
+    munmap(res, n_cfg * sizeof(TuneResult));
+    for (size_t t = 0; t < n_traces; t++) trace_free(&traces[t]);
+    return ret ? 1 : 0;
+}
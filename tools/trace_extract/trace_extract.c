@@ -0,0 +1,225 @@
+// 现场记录提取工具
+//
+// 从控制台抓取的 "trace dump" 输出（文件或stdin）中找出 "#TR:" 行，按
+// include/trace_rec.h 的条目格式解出压缩块和触发记录，每个触发窗口写成一个
+// .sckt 文件，可直接交给 tap_replay 回放。同一序号的块只取第一次出现的。
+//
+//   trace_extract [-o prefix] [log...]
+//     -o  输出文件名前缀（默认 capture），生成 <prefix>_<n>.sckt
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace_codec.h"
+#include "trace_io.h"
+#include "trace_rec.h"
+
+#define LINE_MAX_LEN    2048
+#define ENTRY_MAX       (1 + TRACE_BLOCK_SIZE + 8)
+#define BLOCK_SAMPLES   TRACE_BLOCK_SIZE    // 每块样本数的宽松上限
+
+typedef struct {
+    uint32_t seq;
+    uint16_t len;
+    uint8_t data[TRACE_BLOCK_SIZE];
+} Block;
+
+typedef struct {
+    uint8_t reason;
+    uint32_t ts;
+    uint32_t first, last;
+} Trigger;
+
+static Block *blocks;
+static size_t n_blocks, cap_blocks;
+static Trigger *triggers;
+static size_t n_triggers, cap_triggers;
+
+static const char *const reason_names[GESTURE_NUM] = {
+    [GESTURE_NONE] = "manual",
+    [GESTURE_SINGLE_TAP] = "single",
+    [GESTURE_DOUBLE_TAP] = "double",
+    [GESTURE_TRIPLE_TAP] = "triple",
+    [GESTURE_SHAKE] = "shake",
+    [GESTURE_HOLD_STILL] = "hold",
+};
+
+static int hex_val(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void *grow(void *arr, size_t *cap, size_t n, size_t elem)
+{
+    if (n < *cap) return arr;
+    size_t ncap = *cap ? *cap * 2 : 64;
+    void *p = realloc(arr, ncap * elem);
+    if (!p) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    *cap = ncap;
+    return p;
+}
+
+static const Block *find_block(uint32_t seq)
+{
+    for (size_t i = 0; i < n_blocks; i++) {
+        if (blocks[i].seq == seq) return &blocks[i];
+    }
+    return NULL;
+}
+
+// 解析一个条目，格式错误返回-1
+static int parse_entry(const uint8_t *raw, int n)
+{
+    if (n >= TRACE_BLOCK_HDR_SIZE + 1 && raw[0] == TRACE_ENTRY_BLOCK) {
+        uint16_t len = (uint16_t)(raw[1 + 16] | (raw[1 + 17] << 8));
+        AccelSample tmp[BLOCK_SAMPLES];
+        uint32_t seq;
+
+        if (len > n - 1 || trace_block_decode(&raw[1], len, &seq, tmp, BLOCK_SAMPLES) < 0) {
+            return -1;
+        }
+        if (find_block(seq)) return 0;
+        blocks = grow(blocks, &cap_blocks, n_blocks, sizeof(*blocks));
+        blocks[n_blocks].seq = seq;
+        blocks[n_blocks].len = len;
+        memcpy(blocks[n_blocks].data, &raw[1], len);
+        n_blocks++;
+        return 0;
+    }
+    if (n >= 1 + TRACE_TRIGGER_SIZE && raw[0] == TRACE_ENTRY_TRIGGER) {
+        const uint8_t *p = &raw[1];
+        triggers = grow(triggers, &cap_triggers, n_triggers, sizeof(*triggers));
+        triggers[n_triggers++] = (Trigger){
+            .reason = p[0], .ts = rd_u32(&p[4]), .first = rd_u32(&p[8]), .last = rd_u32(&p[12]),
+        };
+        return 0;
+    }
+    return -1;
+}
+
+static void read_stream(FILE *in, size_t *bad)
+{
+    char line[LINE_MAX_LEN];
+
+    while (fgets(line, sizeof(line), in)) {
+        const char *p = strstr(line, TRACE_LINE_PREFIX);
+        uint8_t raw[ENTRY_MAX];
+        int n = 0;
+
+        if (!p) continue;
+        p += strlen(TRACE_LINE_PREFIX);
+        while (n < (int)sizeof(raw)) {
+            int hi = hex_val(p[0]);
+            int lo = hi < 0 ? -1 : hex_val(p[1]);
+            if (hi < 0 || lo < 0) break;
+            raw[n++] = (uint8_t)((hi << 4) | lo);
+            p += 2;
+        }
+        if (parse_entry(raw, n) != 0) (*bad)++;
+    }
+}
+
+// 触发窗口内的块按序号拼接。时间戳只保存了低32位，跨越回绕时按差值展开；
+// 超过 .sckt 单条记录上限的间隔（休眠）压缩为上限
+static int extract(const Trigger *t, const char *path)
+{
+    static AccelSample tmp[BLOCK_SAMPLES];
+    Trace tr = {0};
+    uint32_t missing = 0, clamped = 0;
+    uint32_t prev_raw = 0;
+    int64_t ts = 0;
+    int64_t trig_off = -1;
+
+    for (uint32_t seq = t->first; seq - t->first <= t->last - t->first; seq++) {
+        const Block *b = find_block(seq);
+        uint32_t s_seq;
+
+        if (!b) {
+            missing++;
+            continue;
+        }
+        int n = trace_block_decode(b->data, b->len, &s_seq, tmp, BLOCK_SAMPLES);
+        for (int i = 0; i < n; i++) {
+            uint32_t raw = (uint32_t)tmp[i].ts;
+            int64_t dt = tr.count ? (int32_t)(raw - prev_raw) : 0;
+
+            if (dt < 0) dt = 0;
+            if (dt > TRACE_DT_MAX_MS) {
+                dt = TRACE_DT_MAX_MS;
+                clamped++;
+            }
+            ts = tr.count ? ts + dt : raw;
+            if (trig_off < 0 && (int32_t)(raw - t->ts) >= 0) {
+                trig_off = ts - (tr.count ? tr.samples[0].ts : ts);
+            }
+            prev_raw = raw;
+            tmp[i].ts = ts;
+            trace_append(&tr, &tmp[i], 0);
+        }
+    }
+
+    int ret = tr.count ? trace_save_bin(path, &tr) : -ENODATA;
+    printf("%s: %s @%u ms, %zu samples, %lld ms",
+           path, t->reason < GESTURE_NUM ? reason_names[t->reason] : "?", t->ts, tr.count,
+           tr.count ? (long long)(tr.samples[tr.count - 1].ts - tr.samples[0].ts) : 0LL);
+    if (trig_off >= 0) printf(", trigger at +%lld ms", (long long)trig_off);
+    if (missing) printf(", %u blocks missing", missing);
+    if (clamped) printf(", %u gaps clamped", clamped);
+    printf("%s\n", ret ? " (not written)" : "");
+    trace_free(&tr);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    const char *prefix = "capture";
+    size_t bad = 0;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:h")) != -1) {
+        switch (opt) {
+        case 'o': prefix = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-o prefix] [log...]\n", argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind >= argc) {
+        read_stream(stdin, &bad);
+    }
+    for (int i = optind; i < argc; i++) {
+        FILE *f = fopen(argv[i], "r");
+        if (!f) {
+            perror(argv[i]);
+            return 1;
+        }
+        read_stream(f, &bad);
+        fclose(f);
+    }
+
+    for (size_t i = 0; i < n_triggers; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s_%02zu.sckt", prefix, i);
+        failed |= extract(&triggers[i], path) != 0;
+    }
+    fprintf(stderr, "%zu blocks, %zu windows, %zu bad entries\n", n_blocks, n_triggers, bad);
+    free(blocks);
+    free(triggers);
+    return (bad || failed) ? 1 : 0;
+}